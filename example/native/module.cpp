@@ -0,0 +1,34 @@
+#include "runtime/native.h"
+
+//=======================================
+// * Example Native Module
+//---------------------------------------
+//   Built by the icm-native-example target, and loaded
+//   by the native-module test.
+//=======================================
+
+using namespace ICM;
+
+double vsum(const vector<double> &v)
+{
+	double s = 0;
+	for (double d : v)
+		s += d;
+	return s;
+}
+
+int_t fib(int_t n)
+{
+	int_t a = 0, b = 1;
+	while (n-- > 0) {
+		int_t t = a + b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+ICM_NATIVE_MODULE(table) {
+	table.insert("vsum", NativeModule::Overloads{ BIND_NATIVE("vsum", vsum) });
+	table.insert("fib", NativeModule::Overloads{ BIND_NATIVE("fib", fib) });
+}
@@ -5,6 +5,7 @@ namespace ICM
 {
 	namespace Compiler
 	{
-		void transform(vector<AST::NodePtr> &);
+		// Return false if the form has an error.
+		bool transform(vector<AST::NodePtr> &);
 	}
 }
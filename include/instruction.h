@@ -57,6 +57,10 @@ namespace ICM
 			// Varb
 			dim,  // dim a type
 			rest, // rest a type
+			// Struct
+			snew, // snew S args...
+			sget, // sget S.f E
+			sset, // sset S.f E V
 		};
 
 		extern BijectionMap<Instruction, string> InstructionName;
@@ -319,6 +323,39 @@ namespace ICM
 			private:
 				string getToString() const { return  Compare::getToString() + ", {" + std::to_string(Index) + "}"; }
 			};
+
+			struct StructNew : public InstDataBase<snew>
+			{
+				explicit StructNew(size_t Struct) : Struct(Struct) {}
+				size_t Struct;
+				vector<Element> Args;
+			private:
+				string getToString() const {
+					string str = TypeBase::GlobalStructTable[Struct].name;
+					if (!Args.empty())
+						str.append(", " + ICM::to_string(Args));
+					return str;
+				}
+			};
+
+			// Get/Set a field, with its offset resolved in compiling.
+			struct StructField : public InstructionData
+			{
+				StructField(Instruction inst, size_t Struct, size_t Field, const Element &Data)
+					: InstructionData(inst), Struct(Struct), Field(Field), Data(Data) {}
+				size_t Struct;
+				size_t Field;
+				Element Data;
+				Element Value; // for sset
+			private:
+				string getToString() const {
+					const TypeBase::StructInfo &info = TypeBase::GlobalStructTable[Struct];
+					string str = info.name + "." + info.fields[Field] + ", " + ICM::to_string(Data);
+					if (inst() == sset)
+						str.append(", " + ICM::to_string(Value));
+					return str;
+				}
+			};
 		}
 
 		class InstructionList : public vector<InstructionData*>
@@ -16,6 +16,7 @@ namespace ICM
 		I_Type,
 		// Struct
 		I_Struct,
+		I_Field,    // Field Accessor (S.f)
 		// Module
 		I_Module,
 	};
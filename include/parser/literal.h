@@ -1,5 +1,6 @@
 #pragma once
 #include "basic.h"
+#include "runtime/number.h"
 
 namespace ICM
 {
@@ -8,6 +9,7 @@ namespace ICM
 		// * Literal
 		// Boolean
 		// Number
+		// Double
 		// String
 		// Symbol
 		namespace Literal
@@ -35,7 +37,8 @@ namespace ICM
 			};
 
 			using Boolean = bool;
-			using Number = int_t;
+			using Number = Rational;
+			using Double = double;
 			using String = StringType;
 			using Symbol = uint_t;
 			using Int = int_t;
@@ -49,7 +52,21 @@ namespace ICM
 			size_t setBoolean(Literal::Boolean v) {
 				return insert(v);
 			}
+			// A Number is not trivially copyable, so it is kept out of line,
+			// and the pool holds its index.
 			size_t setNumber(Literal::Number&& v) {
+				numbers.push_back(std::move(v));
+				return insert(numbers.size() - 1);
+			}
+			const Literal::Number& getNumber(size_t index) const {
+				return numbers[*static_cast<const size_t*>(get(index))];
+			}
+			size_t setDouble(Literal::Double v) {
+				return insert(v);
+			}
+			// Fixed-width integers.
+			template <typename T>
+			size_t setInteger(T v) {
 				return insert(v);
 			}
 			size_t setString(const char *s, size_t len) {
@@ -61,6 +78,9 @@ namespace ICM
 			size_t setUInt(Literal::UInt v) {
 				return insert(v);
 			}
+
+		private:
+			vector<Literal::Number> numbers;
 		};
 
 		extern SerialBijectionMap<string> GlobalIdentNameMap;
@@ -28,6 +28,15 @@ namespace ICM
 		T_Array,         // Array
 		T_List,          // List
 		T_Disperse,      // Disp
+		T_PVector,       // PVector
+		T_Slice,         // Slice
+		T_Deque,         // Deque
+		T_PQueue,        // PQueue
+		// Map Types
+		T_Map,           // Map
+		T_OrdMap,        // OrdMap
+		// Struct Types
+		T_Struct,        // Struct
 		// String Types
 		T_Char,          // Char
 		// Compile Types (Platform Dependent)
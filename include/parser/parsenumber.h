@@ -1,4 +1,5 @@
 #pragma once
+#include "objectenum.h"
 
 namespace ICM
 {
@@ -20,5 +21,10 @@ namespace ICM
 		};
 
 		NumberType parseNumber(const char *ptr, uint64_t &value);
+
+		// An integer with an i/u suffix is of a fixed-width type,
+		// otherwise it is a Number.
+		bool hasIntegerSuffix(const char *ptr);
+		DefaultType getIntegerType(NumberType type);
 	}
 }
@@ -0,0 +1,99 @@
+#pragma once
+#include "basic.h"
+
+namespace ICM
+{
+	//=======================================
+	// * Class BigInt
+	//---------------------------------------
+	//   Sign and magnitude, the magnitude is kept in
+	//   32-bit limbs from the lowest, without leading zero limbs.
+	//=======================================
+	class BigInt
+	{
+		using Limb = uint32_t;
+		using Limbs = vector<Limb>;
+	public:
+		BigInt() {}
+		BigInt(int64_t v);
+
+		// Parse decimal digits in [begin, end).
+		static BigInt parse(const char *begin, const char *end);
+
+		bool isZero() const {
+			return mag.empty();
+		}
+		bool isNegative() const {
+			return neg;
+		}
+		bool fitsInt64() const;
+		int64_t toInt64() const;
+		double to_double() const;
+		string to_string() const;
+		size_t hash() const;
+
+		BigInt operator-() const {
+			BigInt r = *this;
+			r.neg = !r.isZero() && !neg;
+			return r;
+		}
+		BigInt abs() const {
+			BigInt r = *this;
+			r.neg = false;
+			return r;
+		}
+
+		friend BigInt operator+(const BigInt &a, const BigInt &b);
+		friend BigInt operator-(const BigInt &a, const BigInt &b);
+		friend BigInt operator*(const BigInt &a, const BigInt &b);
+		// Truncated division, like the built-in integers.
+		static void divmod(const BigInt &a, const BigInt &b, BigInt &q, BigInt &r);
+		// Floored division.
+		static BigInt floordiv(const BigInt &a, const BigInt &b);
+		friend BigInt operator/(const BigInt &a, const BigInt &b) {
+			BigInt q, r;
+			divmod(a, b, q, r);
+			return q;
+		}
+		friend BigInt operator%(const BigInt &a, const BigInt &b) {
+			BigInt q, r;
+			divmod(a, b, q, r);
+			return r;
+		}
+		friend BigInt gcd(BigInt a, BigInt b);
+
+		// Return -1, 0 or 1.
+		friend int compare(const BigInt &a, const BigInt &b);
+		friend bool operator==(const BigInt &a, const BigInt &b) {
+			return a.neg == b.neg && a.mag == b.mag;
+		}
+		friend bool operator!=(const BigInt &a, const BigInt &b) {
+			return !(a == b);
+		}
+		friend bool operator<(const BigInt &a, const BigInt &b) {
+			return compare(a, b) < 0;
+		}
+
+	private:
+		bool neg = false;
+		Limbs mag;
+
+		constexpr static size_t KaratsubaThreshold = 32;
+
+		void trim();
+		uint64_t low64() const;
+		static int cmpMag(const Limbs &a, const Limbs &b);
+		static Limbs addMag(const Limbs &a, const Limbs &b);
+		// a >= b
+		static Limbs subMag(const Limbs &a, const Limbs &b);
+		static Limbs mulMag(const Limb *a, size_t na, const Limb *b, size_t nb);
+		static Limbs mulSchool(const Limb *a, size_t na, const Limb *b, size_t nb);
+		static void divmodMag(const Limbs &a, const Limbs &b, Limbs &q, Limbs &r);
+		// Divide in place, and return the remainder.
+		static Limb divmodSmall(Limbs &a, Limb b);
+		static void toStringRec(const BigInt &x, const vector<BigInt> &pows, int k, size_t width, string &out);
+	};
+
+	BigInt gcd(BigInt a, BigInt b);
+	int compare(const BigInt &a, const BigInt &b);
+}
@@ -0,0 +1,408 @@
+#pragma once
+#include "basic.h"
+#include <algorithm>
+#include <functional>
+
+namespace ICM
+{
+	namespace Container
+	{
+		//=======================================
+		// * Class BTree
+		//---------------------------------------
+		//   A B+ tree map. The entries are kept in the leaves,
+		//   which are linked in order for iteration and range scans.
+		//   Inner nodes hold separators: every key in child[i]
+		//   is less than key[i], which is not greater than those in child[i + 1].
+		//=======================================
+		template <typename K, typename V, typename Less = std::less<K>>
+		class BTree
+		{
+			constexpr static size_t Order = 32;
+			constexpr static size_t Min = Order / 2;
+
+			// One more slot than Order, so that a node is split after the insert.
+			struct Node {
+				bool isleaf;
+				size_t count = 0;
+				K keys[Order + 1];
+				explicit Node(bool isleaf) : isleaf(isleaf) {}
+			};
+			struct Leaf : public Node {
+				V values[Order + 1];
+				Leaf *next = nullptr;
+				Leaf() : Node(true) {}
+			};
+			struct Inner : public Node {
+				Node *child[Order + 2];
+				Inner() : Node(false) {}
+			};
+
+		public:
+			class const_iterator
+			{
+			public:
+				const_iterator(const Leaf *leaf = nullptr, size_t index = 0) : leaf(leaf), index(index) {
+					skip();
+				}
+				const K& key() const {
+					return leaf->keys[index];
+				}
+				const V& value() const {
+					return leaf->values[index];
+				}
+				const_iterator& operator++() {
+					index++;
+					skip();
+					return *this;
+				}
+				bool operator==(const const_iterator &it) const {
+					return leaf == it.leaf && index == it.index;
+				}
+				bool operator!=(const const_iterator &it) const {
+					return !(*this == it);
+				}
+
+			private:
+				const Leaf *leaf;
+				size_t index;
+
+				// Move past the end of a leaf to the next one.
+				void skip() {
+					while (leaf && index == leaf->count) {
+						leaf = leaf->next;
+						index = 0;
+					}
+				}
+			};
+
+			BTree() : root(new Leaf()) {}
+			BTree(const BTree &bt) : root(nullptr), count(bt.count) {
+				Leaf *last = nullptr;
+				root = copyNode(bt.root, last);
+			}
+			BTree(BTree &&bt) : root(bt.root), count(bt.count) {
+				bt.root = new Leaf();
+				bt.count = 0;
+			}
+			~BTree() {
+				freeNode(root);
+			}
+			BTree& operator=(BTree bt) {
+				std::swap(root, bt.root);
+				std::swap(count, bt.count);
+				return *this;
+			}
+
+			// The keys of [begin, end) should be strictly increasing.
+			// The leaves are filled in one pass, then each level above.
+			template <typename It>
+			static BTree from_sorted(It begin, It end) {
+				BTree bt;
+				size_t n = std::distance(begin, end);
+				if (n <= Order) {
+					Leaf *leaf = static_cast<Leaf*>(bt.root);
+					for (; begin != end; ++begin)
+						push(leaf, *begin);
+					bt.count = n;
+					return bt;
+				}
+				// The nodes of a level, with the least key under each.
+				vector<std::pair<Node*, K>> level;
+				size_t groups = (n + Order - 1) / Order;
+				Leaf *prev = nullptr;
+				for (size_t g : range(0, groups)) {
+					Leaf *leaf = new Leaf();
+					for (size_t size = n / groups + (g < n % groups); leaf->count != size; ++begin)
+						push(leaf, *begin);
+					if (prev)
+						prev->next = leaf;
+					prev = leaf;
+					level.emplace_back(leaf, leaf->keys[0]);
+				}
+				while (level.size() > 1) {
+					vector<std::pair<Node*, K>> upper;
+					size_t m = level.size();
+					groups = (m + Order - 1) / Order;
+					size_t i = 0;
+					for (size_t g : range(0, groups)) {
+						Inner *inner = new Inner();
+						size_t size = m / groups + (g < m % groups);
+						upper.emplace_back(inner, level[i].second);
+						inner->child[0] = level[i++].first;
+						for (size_t j : range(1, size)) {
+							inner->keys[j - 1] = level[i].second;
+							inner->child[j] = level[i++].first;
+						}
+						inner->count = size - 1;
+					}
+					level.swap(upper);
+				}
+				freeNode(bt.root);
+				bt.root = level[0].first;
+				bt.count = n;
+				return bt;
+			}
+
+			size_t size() const {
+				return count;
+			}
+			bool empty() const {
+				return count == 0;
+			}
+			const_iterator begin() const {
+				const Node *node = root;
+				while (!node->isleaf)
+					node = static_cast<const Inner*>(node)->child[0];
+				return const_iterator(static_cast<const Leaf*>(node), 0);
+			}
+			const_iterator end() const {
+				return const_iterator();
+			}
+			// The first entry whose key is not less than key.
+			const_iterator lower_bound(const K &key) const {
+				const Node *node = root;
+				while (!node->isleaf)
+					node = static_cast<const Inner*>(node)->child[upperIndex(node, key)];
+				const K *keys = node->keys;
+				size_t i = std::lower_bound(keys, keys + node->count, key, less) - keys;
+				return const_iterator(static_cast<const Leaf*>(node), i);
+			}
+			const V* find(const K &key) const {
+				const_iterator it = lower_bound(key);
+				if (it == end() || less(key, it.key()))
+					return nullptr;
+				return &it.value();
+			}
+			V* find(const K &key) {
+				return const_cast<V*>(static_cast<const BTree*>(this)->find(key));
+			}
+
+			// Return false if the key was there, and the value is replaced.
+			bool insert(const K &key, const V &value) {
+				K upkey;
+				Node *upnode = nullptr;
+				bool inserted = insert(root, key, value, upkey, upnode);
+				if (upnode) {
+					Inner *inner = new Inner();
+					inner->count = 1;
+					inner->keys[0] = upkey;
+					inner->child[0] = root;
+					inner->child[1] = upnode;
+					root = inner;
+				}
+				if (inserted)
+					count++;
+				return inserted;
+			}
+			bool erase(const K &key) {
+				if (!erase(root, key))
+					return false;
+				count--;
+				if (!root->isleaf && root->count == 0) {
+					Inner *inner = static_cast<Inner*>(root);
+					root = inner->child[0];
+					delete inner;
+				}
+				return true;
+			}
+
+		private:
+			Node *root;
+			size_t count = 0;
+			Less less;
+
+			template <typename P>
+			static void push(Leaf *leaf, const P &entry) {
+				leaf->keys[leaf->count] = entry.first;
+				leaf->values[leaf->count] = entry.second;
+				leaf->count++;
+			}
+			// The child that may hold key.
+			size_t upperIndex(const Node *node, const K &key) const {
+				return std::upper_bound(node->keys, node->keys + node->count, key, less) - node->keys;
+			}
+
+			bool insert(Node *node, const K &key, const V &value, K &upkey, Node* &upnode) {
+				if (node->isleaf) {
+					Leaf *leaf = static_cast<Leaf*>(node);
+					size_t i = std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, less) - leaf->keys;
+					if (i != leaf->count && !less(key, leaf->keys[i])) {
+						leaf->values[i] = value;
+						return false;
+					}
+					std::move_backward(leaf->keys + i, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+					std::move_backward(leaf->values + i, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+					leaf->keys[i] = key;
+					leaf->values[i] = value;
+					if (++leaf->count > Order)
+						split(leaf, upkey, upnode);
+					return true;
+				}
+				Inner *inner = static_cast<Inner*>(node);
+				size_t i = upperIndex(inner, key);
+				K ckey;
+				Node *cnode = nullptr;
+				bool inserted = insert(inner->child[i], key, value, ckey, cnode);
+				if (cnode) {
+					std::move_backward(inner->keys + i, inner->keys + inner->count, inner->keys + inner->count + 1);
+					std::move_backward(inner->child + i + 1, inner->child + inner->count + 1, inner->child + inner->count + 2);
+					inner->keys[i] = ckey;
+					inner->child[i + 1] = cnode;
+					if (++inner->count > Order)
+						split(inner, upkey, upnode);
+				}
+				return inserted;
+			}
+			void split(Leaf *leaf, K &upkey, Node* &upnode) {
+				Leaf *right = new Leaf();
+				size_t mid = leaf->count / 2;
+				right->count = leaf->count - mid;
+				std::move(leaf->keys + mid, leaf->keys + leaf->count, right->keys);
+				std::move(leaf->values + mid, leaf->values + leaf->count, right->values);
+				leaf->count = mid;
+				right->next = leaf->next;
+				leaf->next = right;
+				upkey = right->keys[0];
+				upnode = right;
+			}
+			void split(Inner *inner, K &upkey, Node* &upnode) {
+				Inner *right = new Inner();
+				size_t mid = inner->count / 2;
+				right->count = inner->count - mid - 1;
+				std::move(inner->keys + mid + 1, inner->keys + inner->count, right->keys);
+				std::copy(inner->child + mid + 1, inner->child + inner->count + 1, right->child);
+				upkey = inner->keys[mid];
+				inner->count = mid;
+				upnode = right;
+			}
+
+			bool erase(Node *node, const K &key) {
+				if (node->isleaf) {
+					Leaf *leaf = static_cast<Leaf*>(node);
+					size_t i = std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, less) - leaf->keys;
+					if (i == leaf->count || less(key, leaf->keys[i]))
+						return false;
+					std::move(leaf->keys + i + 1, leaf->keys + leaf->count, leaf->keys + i);
+					std::move(leaf->values + i + 1, leaf->values + leaf->count, leaf->values + i);
+					leaf->count--;
+					return true;
+				}
+				Inner *inner = static_cast<Inner*>(node);
+				size_t i = upperIndex(inner, key);
+				if (!erase(inner->child[i], key))
+					return false;
+				if (inner->child[i]->count < Min)
+					rebalance(inner, i);
+				return true;
+			}
+			// Refill child i of inner from a sibling, or merge it with one.
+			void rebalance(Inner *inner, size_t i) {
+				Node *left = i > 0 ? inner->child[i - 1] : nullptr;
+				Node *right = i < inner->count ? inner->child[i + 1] : nullptr;
+				if (left && left->count > Min)
+					borrowLeft(inner, i);
+				else if (right && right->count > Min)
+					borrowRight(inner, i);
+				else if (left)
+					merge(inner, i - 1);
+				else if (right)
+					merge(inner, i);
+			}
+			void borrowLeft(Inner *inner, size_t i) {
+				Node *node = inner->child[i];
+				Node *left = inner->child[i - 1];
+				std::move_backward(node->keys, node->keys + node->count, node->keys + node->count + 1);
+				if (node->isleaf) {
+					Leaf *leaf = static_cast<Leaf*>(node), *lleaf = static_cast<Leaf*>(left);
+					std::move_backward(leaf->values, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+					leaf->keys[0] = std::move(lleaf->keys[lleaf->count - 1]);
+					leaf->values[0] = std::move(lleaf->values[lleaf->count - 1]);
+					inner->keys[i - 1] = leaf->keys[0];
+				}
+				else {
+					Inner *in = static_cast<Inner*>(node), *lin = static_cast<Inner*>(left);
+					std::copy_backward(in->child, in->child + in->count + 1, in->child + in->count + 2);
+					in->keys[0] = std::move(inner->keys[i - 1]);
+					in->child[0] = lin->child[lin->count];
+					inner->keys[i - 1] = std::move(lin->keys[lin->count - 1]);
+				}
+				left->count--;
+				node->count++;
+			}
+			void borrowRight(Inner *inner, size_t i) {
+				Node *node = inner->child[i];
+				Node *right = inner->child[i + 1];
+				if (node->isleaf) {
+					Leaf *leaf = static_cast<Leaf*>(node), *rleaf = static_cast<Leaf*>(right);
+					leaf->keys[leaf->count] = std::move(rleaf->keys[0]);
+					leaf->values[leaf->count] = std::move(rleaf->values[0]);
+					std::move(rleaf->keys + 1, rleaf->keys + rleaf->count, rleaf->keys);
+					std::move(rleaf->values + 1, rleaf->values + rleaf->count, rleaf->values);
+					inner->keys[i] = rleaf->keys[0];
+				}
+				else {
+					Inner *in = static_cast<Inner*>(node), *rin = static_cast<Inner*>(right);
+					in->keys[in->count] = std::move(inner->keys[i]);
+					in->child[in->count + 1] = rin->child[0];
+					inner->keys[i] = std::move(rin->keys[0]);
+					std::move(rin->keys + 1, rin->keys + rin->count, rin->keys);
+					std::copy(rin->child + 1, rin->child + rin->count + 1, rin->child);
+				}
+				right->count--;
+				node->count++;
+			}
+			// Merge child i + 1 of inner into child i.
+			void merge(Inner *inner, size_t i) {
+				Node *node = inner->child[i];
+				Node *right = inner->child[i + 1];
+				if (node->isleaf) {
+					Leaf *leaf = static_cast<Leaf*>(node), *rleaf = static_cast<Leaf*>(right);
+					std::move(rleaf->keys, rleaf->keys + rleaf->count, leaf->keys + leaf->count);
+					std::move(rleaf->values, rleaf->values + rleaf->count, leaf->values + leaf->count);
+					leaf->count += rleaf->count;
+					leaf->next = rleaf->next;
+					delete rleaf;
+				}
+				else {
+					Inner *in = static_cast<Inner*>(node), *rin = static_cast<Inner*>(right);
+					in->keys[in->count] = std::move(inner->keys[i]);
+					std::move(rin->keys, rin->keys + rin->count, in->keys + in->count + 1);
+					std::copy(rin->child, rin->child + rin->count + 1, in->child + in->count + 1);
+					in->count += rin->count + 1;
+					delete rin;
+				}
+				std::move(inner->keys + i + 1, inner->keys + inner->count, inner->keys + i);
+				std::copy(inner->child + i + 2, inner->child + inner->count + 1, inner->child + i + 1);
+				inner->count--;
+			}
+
+			// last is the last leaf copied, to link the next one to.
+			static Node* copyNode(const Node *node, Leaf* &last) {
+				if (node->isleaf) {
+					Leaf *leaf = new Leaf(*static_cast<const Leaf*>(node));
+					leaf->next = nullptr;
+					if (last)
+						last->next = leaf;
+					last = leaf;
+					return leaf;
+				}
+				const Inner *src = static_cast<const Inner*>(node);
+				Inner *inner = new Inner(*src);
+				for (size_t i : range(0, src->count + 1))
+					inner->child[i] = copyNode(src->child[i], last);
+				return inner;
+			}
+			static void freeNode(Node *node) {
+				if (node->isleaf) {
+					delete static_cast<Leaf*>(node);
+					return;
+				}
+				Inner *inner = static_cast<Inner*>(node);
+				for (size_t i : range(0, inner->count + 1))
+					freeNode(inner->child[i]);
+				delete inner;
+			}
+		};
+	}
+}
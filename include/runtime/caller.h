@@ -1,119 +1,274 @@
 #pragma once
-#include "object.h"
+#include "basic.h"
+#include "runtime/function.h"
+#include "runtime/objectdef.h"
+#include "runtime/fixedint.h"
+#include <cstring>
+#include <limits>
+#include <utility>
 
-template <typename... Ts> struct List;
-
-template <typename LTs, typename T>
-struct PushBack;
-template <template <typename...> class LTs, typename... Ts, typename T>
-struct PushBack<LTs<Ts...>, T> { using Type = LTs<Ts..., T>; };
+namespace ICM
+{
+	namespace Runtime
+	{
+		//=======================================
+		// * Template Native<T>
+		//---------------------------------------
+		//   How a C++ type crosses to the interpreter.
+		//   Type   : the type in the signature.
+		//   check  : whether the argument fits in T.
+		//   get    : the argument as T, by reference if it is not converted.
+		//   store  : write the result into the slot (see Objects::resultSlot).
+		//=======================================
+		template <typename T, typename = void>
+		struct Native;
 
-template <typename LTs, typename T>
-struct PushFront;
-template <template <typename...> class LTs, typename... Ts, typename T>
-struct PushFront<LTs<Ts...>, T> { using Type = LTs<T, Ts...>; };
+		// Integers, as Numbers in the range of T.
+		template <typename T>
+		struct Native<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+		{
+			constexpr static DefaultType Type = T_Number;
+			static bool check(const Object *op) {
+				const Rational &n = op->dat<T_Number>();
+				if (!n.isInteger())
+					return false;
+				int64_t i = n.num();
+				if (std::is_unsigned<T>::value)
+					return i >= 0 && (uint64_t)i <= (uint64_t)std::numeric_limits<T>::max();
+				return i >= (int64_t)std::numeric_limits<T>::min() && i <= (int64_t)std::numeric_limits<T>::max();
+			}
+			static T get(const Object *op) {
+				return (T)op->dat<T_Number>().num();
+			}
+			static void store(Object* &result, T v) {
+				if (std::is_unsigned<T>::value)
+					Objects::resultSlot<T_Number>(result) = FixedInt::toNumber(T_UInt64, (uint64_t)v);
+				else
+					Objects::resultSlot<T_Number>(result) = Rational((int64_t)v);
+			}
+		};
 
-template <typename LNs, size_t N>
-struct PushBackN;
-template <template <size_t...> class LNs, size_t... Ns, size_t N>
-struct PushBackN<LNs<Ns...>, N> { using Type = LNs<Ns..., N>; };
+		template <typename T>
+		struct Native<T, std::enable_if_t<std::is_floating_point<T>::value>>
+		{
+			constexpr static DefaultType Type = T_Double;
+			static bool check(const Object *) {
+				return true;
+			}
+			static T get(const Object *op) {
+				return (T)op->dat<T_Double>();
+			}
+			static void store(Object* &result, T v) {
+				Objects::resultSlot<T_Double>(result) = v;
+			}
+		};
 
-template <typename LNs, size_t N>
-struct PushFrontN;
-template <template <size_t...> class LNs, size_t... Ns, size_t N>
-struct PushFrontN<LNs<Ns...>, N> { using Type = LNs<N, Ns...>; };
+		template <>
+		struct Native<bool>
+		{
+			constexpr static DefaultType Type = T_Boolean;
+			static bool check(const Object *) {
+				return true;
+			}
+			static bool get(const Object *op) {
+				return op->dat<T_Boolean>();
+			}
+			static void store(Object* &result, bool v) {
+				Objects::resultSlot<T_Boolean>(result) = v;
+			}
+		};
 
-namespace Runtime
-{
-	using FuncResult = ICM::Object*&;
-	using FuncArgument = const ICM::DataList&;
-	using FuncCaller = void(FuncResult, FuncArgument);
+		// Strings are copied, as Strings hold a C string.
+		template <>
+		struct Native<string>
+		{
+			constexpr static DefaultType Type = T_String;
+			static bool check(const Object *) {
+				return true;
+			}
+			static string get(const Object *op) {
+				return op->dat<T_String>().c_str();
+			}
+			static void store(Object* &result, const string &v) {
+				char *data = new char[v.size() + 1];
+				std::memcpy(data, v.c_str(), v.size() + 1);
+				Objects::resultSlot<T_String>(result) = TypeBase::StringType(data);
+			}
+		};
+		template <>
+		struct Native<const char*>
+		{
+			constexpr static DefaultType Type = T_String;
+			static bool check(const Object *) {
+				return true;
+			}
+			static const char* get(const Object *op) {
+				return op->dat<T_String>().c_str();
+			}
+			static void store(Object* &result, const char *v) {
+				Native<string>::store(result, v);
+			}
+		};
 
-	inline void call(FuncCaller *func, FuncResult res, FuncArgument argv) {
-		func(res, argv);
-	}
+		// The elements are passed as they are.
+		template <>
+		struct Native<TypeBase::ListType>
+		{
+			constexpr static DefaultType Type = T_List;
+			static bool check(const Object *) {
+				return true;
+			}
+			static const TypeBase::ListType& get(const Object *op) {
+				return op->dat<T_List>();
+			}
+			static void store(Object* &result, const TypeBase::ListType &v) {
+				Objects::resultSlot<T_List>(result) = v;
+			}
+		};
 
-	template <typename T>
-	inline void setResult(FuncResult res, T &&data) {
-		// TODO
-		static T sdata;
-		sdata = data;
-		res = new ICM::Object(ICM::Types::CType<T>::index, &sdata);
-	}
+		// Lists of the scalars above, converted element by element.
+		template <typename E>
+		struct Native<vector<E>, std::enable_if_t<std::is_arithmetic<E>::value>>
+		{
+			constexpr static DefaultType Type = T_List;
+			static bool check(const Object *op) {
+				for (Object *e : op->dat<T_List>().getData())
+					if (e->type != Native<E>::Type || !Native<E>::check(e))
+						return false;
+				return true;
+			}
+			static vector<E> get(const Object *op) {
+				const TypeBase::ListType &lt = op->dat<T_List>();
+				vector<E> v;
+				v.reserve(lt.size());
+				for (Object *e : lt.getData())
+					v.push_back(Native<E>::get(e));
+				return v;
+			}
+			static void store(Object* &result, const vector<E> &v) {
+				TypeBase::ListType &lt = Objects::resultSlot<T_List>(result);
+				lt.clear();
+				lt.reserve(v.size());
+				for (const E &e : v) {
+					Object *op = nullptr;
+					Native<E>::store(op, e);
+					lt.push(op);
+				}
+			}
+		};
 
-	template <typename T, size_t N>
-	inline T getArgument(FuncArgument argv) {
-		//ICM::println("(", typeid(T).name(), ", ", N, ")");
-		return argv[N]->dat<ICM::Types::CType<T>::index>();
-	}
+		//=======================================
+		// * Struct NativeResult<T>
+		//---------------------------------------
+		//   The result of a native function that can fail:
+		//   the value, or the error if error is not null.
+		//=======================================
+		template <typename T>
+		struct NativeResult
+		{
+			NativeResult(T value) : value(value) {}
+			static NativeResult fail(const char *error) {
+				NativeResult r{ T() };
+				r.error = error;
+				return r;
+			}
 
-	template <typename _TR, typename... _TAs>
-	struct CallerBase
-	{
-		using FuncType = _TR(*) (_TAs...);
+			T value;
+			const char *error = nullptr;
+		};
 
-	private:
-		template <typename... Pair>
-		struct FuncList {
-			template <FuncType f>
-			inline constexpr static _TR func(FuncArgument argv) {
-				return f(Pair::func(argv)...);
+		template <typename T>
+		struct Native<NativeResult<T>>
+		{
+			constexpr static DefaultType Type = Native<T>::Type;
+			static void store(Object* &result, const NativeResult<T> &r) {
+				if (r.error)
+					result = createError(r.error).get();
+				else
+					Native<T>::store(result, r.value);
 			}
 		};
 
-		template <typename T, size_t N>
-		struct GetArgument {
-			constexpr static auto func = getArgument<T, N>;
+		template <>
+		struct Native<void>
+		{
+			constexpr static DefaultType Type = T_Nil;
 		};
 
-		template <typename List, template <typename, size_t> class Pair, typename... Ts>
-		struct GetListFunc
-		{
-		private:
-			template <size_t NC, size_t N, typename UTs, typename... _Ts>
-			struct Sub;
+		//=======================================
+		// * Class NativeFunc<F, f>
+		//---------------------------------------
+		//   The C++ function f as an overload, with the signature
+		//   deduced from its type. Arguments are taken by value
+		//   or by const reference; the result is written in place.
+		//=======================================
+		template <typename F, F f>
+		class NativeFunc;
 
-			template <size_t NC, size_t N, typename UTs, typename T0, typename... _Ts>
-			struct Sub<NC, N, UTs, T0, _Ts...> : Sub<NC, N - 1, typename PushBack<UTs, Pair<T0, NC - N>>::Type, _Ts...> {};
+		template <typename R, typename... Args, R(*f)(Args...)>
+		class NativeFunc<R(*)(Args...), f> : public Function::FuncInitObject
+		{
+			template <typename A>
+			using Arg = Native<std::decay_t<A>>;
+			using Result = Native<std::decay_t<R>>;
 
-			template <size_t NC, typename UTs>
-			struct Sub<NC, 0, UTs> { using Type = UTs; };
+			constexpr static bool allOf(std::initializer_list<bool> list) {
+				for (bool b : list)
+					if (!b)
+						return false;
+				return true;
+			}
+			static_assert(allOf({ true, (!std::is_lvalue_reference<Args>::value || std::is_const<std::remove_reference_t<Args>>::value)... }),
+				"Arguments of a native function should be values or const references.");
 
 		public:
-			using Type = Sub<sizeof...(Ts), sizeof...(Ts), List, Ts...>;
-		};
+			explicit NativeFunc(const char *name) : name(name) {}
 
-	public:
-		template <FuncType f>
-		inline static void call(FuncResult res, FuncArgument argv) {
-			setResult<_TR>(res, GetListFunc<FuncList<>, GetArgument, _TAs...>::Type::Type::template func<f>(argv));
-		}
-	};
+		private:
+			const char *name;
 
-	template <typename _TR>
-	struct CallerBase<_TR, void>
-	{
-		template <_TR(*f) (void)>
-		inline static void call(FuncResult res, FuncArgument argv) {
-			setResult<_TR>(res, f());
-		}
-	};
-	
-	template <>
-	struct CallerBase<void, void>
-	{
-		template <void(*f) (void)>
-		inline static void call(FuncResult res, FuncArgument argv) {
-			f();
-		}
-	};
+			Function::Signature sign() const {
+				// The types are copied, as the Type members have no definitions to bind to.
+				return Function::Signature({ DefaultType(Arg<Args>::Type)... }, DefaultType(Result::Type));
+			}
+			ObjectPtr func(const DataList &list) const {
+				return funcByL(list);
+			}
+			bool funcL(Object* &result, const LDataList &list) const {
+				call(result, list, std::index_sequence_for<Args...>());
+				return true;
+			}
 
-	template <typename _LTA, typename _TR>
-	struct Caller;
+			template <size_t... I>
+			void call(Object* &result, const LDataList &list, std::index_sequence<I...>) const {
+				bool fit[] = { true, Arg<Args>::check(list[I])... };
+				for (size_t i : range(0, sizeof...(Args))) {
+					if (!fit[i + 1]) {
+						result = createError("'" + list[i]->to_string() + "' does not fit argument " + std::to_string(i + 1) + " of '" + name + "'.").get();
+						return;
+					}
+				}
+				invoke(result, std::is_void<R>(), Arg<Args>::get(list[I])...);
+			}
+			template <typename... Ts>
+			static void invoke(Object* &result, std::false_type, Ts&&... args) {
+				Result::store(result, f(std::forward<Ts>(args)...));
+			}
+			// A void function returns Nil.
+			template <typename... Ts>
+			static void invoke(Object* &result, std::true_type, Ts&&... args) {
+				f(std::forward<Ts>(args)...);
+				Objects::resultSlot<T_Nil>(result);
+			}
+		};
 
-	template <template <typename...> class L, typename... _TAs, typename _TR>
-	struct Caller<L<_TAs...>, _TR>
-	{
-		using Type = typename PushFront<CallerBase<_TAs...>, _TR>::Type;
-	};
+		// The overload of f, named name in the errors.
+		template <typename F, F f>
+		Function::FuncInitObject* bind_native(const char *name) {
+			return new NativeFunc<F, f>(name);
+		}
+	}
 }
+
+// BIND_NATIVE("name", fn) for the overload of the function fn.
+#define BIND_NATIVE(_Name, _F) ICM::Runtime::bind_native<decltype(&_F), &_F>(_Name)
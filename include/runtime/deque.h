@@ -0,0 +1,166 @@
+#pragma once
+#include "basic.h"
+#include <functional>
+
+namespace ICM
+{
+	namespace Container
+	{
+		//=======================================
+		// * Class Deque
+		//---------------------------------------
+		//   A ring buffer with a power of two capacity,
+		//   doubled when it is full.
+		//=======================================
+		template <typename T>
+		class Deque
+		{
+		public:
+			Deque() {}
+
+			size_t size() const {
+				return count;
+			}
+			bool empty() const {
+				return count == 0;
+			}
+			T& operator[](size_t index) {
+				assert(index < count);
+				return buf[(head + index) & (buf.size() - 1)];
+			}
+			const T& operator[](size_t index) const {
+				assert(index < count);
+				return buf[(head + index) & (buf.size() - 1)];
+			}
+			T& front() {
+				return (*this)[0];
+			}
+			T& back() {
+				return (*this)[count - 1];
+			}
+
+			void push_back(T v) {
+				grow();
+				buf[(head + count) & (buf.size() - 1)] = std::move(v);
+				count++;
+			}
+			void push_front(T v) {
+				grow();
+				head = (head - 1) & (buf.size() - 1);
+				buf[head] = std::move(v);
+				count++;
+			}
+			T pop_back() {
+				assert(count != 0);
+				T &e = back();
+				T v = std::move(e);
+				e = T();
+				count--;
+				return v;
+			}
+			T pop_front() {
+				assert(count != 0);
+				T v = std::move(buf[head]);
+				buf[head] = T();
+				head = (head + 1) & (buf.size() - 1);
+				count--;
+				return v;
+			}
+			void reserve(size_t length) {
+				if (length <= buf.size())
+					return;
+				size_t cap = buf.empty() ? (size_t)MinSize : buf.size();
+				while (cap < length)
+					cap *= 2;
+				vector<T> nbuf(cap);
+				for (size_t i : range(0, count))
+					nbuf[i] = std::move((*this)[i]);
+				buf.swap(nbuf);
+				head = 0;
+			}
+
+		private:
+			constexpr static size_t MinSize = 8;
+
+			vector<T> buf;
+			size_t head = 0;
+			size_t count = 0;
+
+			void grow() {
+				if (count == buf.size())
+					reserve(count + 1);
+			}
+		};
+
+		//=======================================
+		// * Class BinaryHeap
+		//---------------------------------------
+		//   A heap in a Deque, with the least element on top.
+		//=======================================
+		template <typename T, typename Less = std::less<T>>
+		class BinaryHeap
+		{
+		public:
+			BinaryHeap() {}
+
+			size_t size() const {
+				return data.size();
+			}
+			bool empty() const {
+				return data.empty();
+			}
+			const T& top() const {
+				return data[0];
+			}
+			// In heap order.
+			const Deque<T>& getData() const {
+				return data;
+			}
+
+			void push(T v) {
+				data.push_back(std::move(v));
+				siftUp(data.size() - 1);
+			}
+			T pop() {
+				assert(!data.empty());
+				T last = data.pop_back();
+				if (data.empty())
+					return last;
+				T v = std::move(data.front());
+				data.front() = std::move(last);
+				siftDown(0);
+				return v;
+			}
+
+		private:
+			Deque<T> data;
+			Less less;
+
+			void siftUp(size_t i) {
+				while (i != 0) {
+					size_t parent = (i - 1) / 2;
+					if (!less(data[i], data[parent]))
+						break;
+					std::swap(data[i], data[parent]);
+					i = parent;
+				}
+			}
+			void siftDown(size_t i) {
+				size_t n = data.size();
+				while (true) {
+					size_t least = i;
+					size_t left = 2 * i + 1;
+					size_t right = left + 1;
+					if (left < n && less(data[left], data[least]))
+						least = left;
+					if (right < n && less(data[right], data[least]))
+						least = right;
+					if (least == i)
+						break;
+					std::swap(data[i], data[least]);
+					i = least;
+				}
+			}
+		};
+	}
+}
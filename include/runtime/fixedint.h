@@ -0,0 +1,40 @@
+#pragma once
+#include "basic.h"
+#include "runtime/object.h"
+#include "runtime/number.h"
+
+namespace ICM
+{
+	//=======================================
+	// * FixedInt
+	//---------------------------------------
+	//   Int8..UInt64 (and Byte..QWord, Int, UInt).
+	//   A value is handled as 64 bits, truncated to its width
+	//   and sign-extended for the signed types, so that
+	//   the arithmetic wraps around like the native one.
+	//=======================================
+	namespace FixedInt
+	{
+		enum Operator { Add, Sub, Mul, Div, Rem, And, Or, Xor, Shl, Shr };
+
+		bool isFixedInt(TypeUnit type);
+		bool isSigned(TypeUnit type);
+		// In bits.
+		unsigned width(TypeUnit type);
+		uint64_t normalize(TypeUnit type, uint64_t v);
+
+		// Unbox/Box
+		uint64_t load(const Object *op);
+		Object* box(TypeUnit type, uint64_t v);
+		// Box into the result slot, see Objects::resultSlot.
+		void box(Object* &result, TypeUnit type, uint64_t v);
+		// Return false if it is not an integer. Numbers wrap around too.
+		bool fromNumber(TypeUnit type, const Rational &n, uint64_t &r);
+		Rational toNumber(TypeUnit type, uint64_t v);
+
+		// Return false on division by zero.
+		bool calc(TypeUnit type, Operator op, uint64_t a, uint64_t b, uint64_t &r);
+		// Return -1, 0 or 1.
+		int compare(TypeUnit type, uint64_t a, uint64_t b);
+	}
+}
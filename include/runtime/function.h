@@ -40,23 +40,72 @@ namespace ICM
 
 	namespace Function
 	{
+		class FuncObject;
+		// The arguments of a batch call, one array per parameter.
+		using Columns = vector<Object* const*>;
+
+		//=======================================
+		// * Class FuncInitObject
+		//---------------------------------------
+		//   A builtin overload as a class. The object is kept
+		//   for the lifetime of the program, as the data of the overload.
+		//=======================================
+		class FuncInitObject
+		{
+			friend class FuncObject;
+		public:
+			FuncObject get_f() const;
+
+		protected:
+			virtual Signature sign() const = 0;
+			virtual ObjectPtr func(const DataList &list) const = 0;
+			// Write the result into the slot, which is null or owned by the caller,
+			// and return true. The arguments are only read, and never kept.
+			// Return false if the overload has no such version.
+			virtual bool funcL(Object* &, const LDataList &) const {
+				return false;
+			}
+			// Call on each of the length rows of the columns, with a new object
+			// for every result, and return true. The results may keep the arguments.
+			// Return false if it is unsupported. The default calls funcL on each row.
+			virtual bool funcV(Object **result, const Columns &columns, size_t length) const;
+			// func of an overload written as funcL.
+			ObjectPtr funcByL(const DataList &list) const {
+				Object *result = nullptr;
+				funcL(result, list);
+				return ObjectPtr(result);
+			}
+		};
+
 		//=======================================
 		// * Class FuncObject
+		//---------------------------------------
+		//   A plain function, or a FuncInitObject.
+		//   A call is a single indirect call to either.
 		//=======================================
 		class FuncObject
 		{
 		public:
 			FuncObject() = default;
-			FuncObject(const FuncPtr &func, const Signature &sign, const LFuncPtr &Lfunc = nullptr)
-				: func(func), sign(sign), Lfunc(Lfunc) {}
+			FuncObject(FuncPtr func, const Signature &sign)
+				: func(func), sign(sign) {}
+			FuncObject(const FuncInitObject *object, const Signature &sign)
+				: object(object), sign(sign) {}
 
 			template <typename... Args>
 			bool checkType(Args... args) const {
 				return sign.checkType(args...);
 			}
 			ObjectPtr call(const DataList &dl) const {
-				// If there was a crash, make sure that the pointer 'func' is effective.
-				return func(dl);
+				return object ? object->func(dl) : func(dl);
+			}
+			// See FuncInitObject::funcL. A plain function has no funcL.
+			bool callL(Object* &result, const LDataList &dl) const {
+				return object && object->funcL(result, dl);
+			}
+			// See FuncInitObject::funcV.
+			bool callV(Object **result, const Columns &columns, size_t length) const {
+				return object && object->funcV(result, columns, length);
 			}
 
 			string to_string() const {
@@ -67,34 +116,21 @@ namespace ICM
 			}
 
 		private:
-			FuncPtr func;
+			FuncPtr func = nullptr;
+			const FuncInitObject *object = nullptr;
 			Signature sign;
-			LFuncPtr Lfunc;
 		};
 
-		//=======================================
-		// * Class FuncInitObject
-		//=======================================
-		class FuncInitObject
-		{
-			using LFP = ICM::Object*(const Common::lightlist<Object*> &); // TODO
-		public:
-			FuncObject get_f() {
-				const auto &f1 = std::bind(&FuncInitObject::func, this, std::placeholders::_1);
-				const auto &f2 = std::bind(&FuncInitObject::funcL, this, std::placeholders::_1, std::placeholders::_2);
-				return FuncObject(f1, sign(), f2);
-			}
-
-		protected:
-			virtual Signature sign() const = 0;
-			virtual ObjectPtr func(const DataList &list) const = 0;
-			virtual void funcL(Object* &, const LDataList &) const {
-				println("Error : Not find funcL.");
-			}
-		};
+		inline FuncObject FuncInitObject::get_f() const {
+			return FuncObject(this, sign());
+		}
 
 		//=======================================
 		// * Class SignTree
+		//---------------------------------------
+		//   The parameter types of the overloads, sharing common prefixes.
+		//   An overload ends at a null node holding its index,
+		//   after the node of its last parameter.
 		//=======================================
 		class SignTree
 		{
@@ -106,33 +142,28 @@ namespace ICM
 			struct Node
 			{
 			public:
-				Node() : data(nullptr), parent(nullptr) {}
-				Node(const TypeObjectPtr &top, Node* parent)
-					: data(top), parent(parent) {}
+				Node() : data(nullptr), parent(nullptr), index(0) {}
+				Node(const TypeObjectPtr &top, Node* parent, size_t index)
+					: data(top), parent(parent), index(index) {}
 
+				// Function types with a signature are never shared,
+				// as TypeObject::operator== does not compare signatures.
 				Node* find(const TypeObject &to) const {
+					if (to.isFunc() && to.haveSign())
+						return nullptr;
 					for (auto &p : children) {
-						if (p->data && *p->data == to)
-							return p.get();
-					}
-					return nullptr;
-				}
-				Node* find(const TypeObjectPtr &to) const {
-					for (auto &p : children) {
-						if (p->data == nullptr && to == nullptr)
-							return p.get();
-						else if (p->data == to)
+						if (p->data && *p->data == to && !p->data->haveSign())
 							return p.get();
 					}
 					return nullptr;
 				}
-				Node* push(const TypeObjectPtr &top) {
-					children.push_back(NodePtr(new Node(top, this)));
+				Node* push(const TypeObjectPtr &top, size_t index) {
+					children.push_back(NodePtr(new Node(top, this, index)));
 					return children.back().get();
 				}
-				Node* pushEnd(size_t id) {
-					NodePtr node(new Node(nullptr, this));
-					node->index = id;
+				Node* pushEnd(size_t index, bool isargs) {
+					NodePtr node(new Node(nullptr, this, index));
+					node->isargs = isargs;
 					children.push_back(std::move(node));
 					return children.back().get();
 				}
@@ -145,37 +176,16 @@ namespace ICM
 				bool isNull() const {
 					return data == nullptr;
 				}
-				bool isFunc() const {
-					return data->isFunc();
-				}
-				const Signature& getSign() const {
-					return data->getSign();
-				}
+				// For an end, the index of its overload. Otherwise the least
+				// index of the overloads through it, which is the one that created it,
+				// so the children are in increasing order of index.
 				size_t getIndex() const {
 					return index;
 				}
-				bool canEnd() const {
-					for (const NodePtr &np : children) {
-						if (np->isNull())
-							return true;
-					}
-					return false;
-				}
-				bool canEnd(size_t &index) const {
-					for (const NodePtr &np : children) {
-						if (np->isNull()) {
-							index = np->index;
-							return true;
-						}
-					}
-					return false;
-				}
+				// For an end, whether the last parameter repeats.
 				bool isArgs() const {
 					return isargs;
 				}
-				void setArgs() {
-					isargs = true;
-				}
 				Node* getParent() const {
 					return parent;
 				}
@@ -188,28 +198,17 @@ namespace ICM
 				bool isargs = false;
 			};
 		public:
-			SignTree() : root(new Node()), level(1) {}
+			SignTree() : root(new Node()) {}
 
 			void insert(const FuncObject &funcO) {
+				size_t index = funcdata.size();
 				Node* currptr = root.get();
-				size_t count = 1;
 				for (const TypeObject &to : funcO.getSign().getInType()) {
 					Node* ptr = currptr->find(to);
-					if (ptr) {
-						currptr = ptr;
-					}
-					else {
-						currptr = currptr->push(TypeObjectPtr(new TypeObject(to)));
-						if (count == level.size())
-							level.push_back(vector<const vector<NodePtr>*>());
-						level[count].push_back(&currptr->getChildren());
-					}
-					count++;
-				}
-				if (funcO.getSign().isLastArgs()) {
-					currptr->setArgs();
+					currptr = ptr ? ptr : currptr->push(TypeObjectPtr(new TypeObject(to)), index);
 				}
-				currptr->pushEnd(funcdata.size());
+				bool isargs = funcO.getSign().isLastArgs() && currptr != root.get();
+				currptr->pushEnd(index, isargs);
 				funcdata.push_back(&funcO);
 			}
 			const Node* getRoot() const {
@@ -221,10 +220,16 @@ namespace ICM
 
 		private:
 			NodePtr root;
-			vector<vector<const vector<NodePtr>*>> level;
 			vector<const FuncObject*> funcdata;
 		};
 
+		//=======================================
+		// * Class SignTreeMatch
+		//---------------------------------------
+		//   Find the first overload, in the order of insertion,
+		//   that accepts the argument types, as a linear scan would.
+		//   Subtrees which cannot hold an earlier overload are skipped.
+		//=======================================
 		class SignTreeMatch
 		{
 			using Node = SignTree::Node;
@@ -232,12 +237,16 @@ namespace ICM
 			SignTreeMatch(const SignTree &st)
 				: ST(st) {}
 
-			const Node* checkSingle(const Node *data, const Node *p, const TypeObject &type, bool &change);
-			const Node* checkSingle(const Node *data, const TypeObject &type, size_t &index);
 			const FuncObject* match(const lightlist<TypeObject> &argT);
 
 		private:
 			const SignTree& ST;
+			const lightlist<TypeObject> *argT = nullptr;
+			size_t best = 0;
+
+			// node has taken the arguments before pos.
+			void search(const Node *node, size_t pos);
+			bool matchArgs(const Node *node, size_t pos) const;
 		};
 	}
 
@@ -246,5 +255,11 @@ namespace ICM
 	//=======================================
 	size_t getCallID(const FuncTableUnit &ftu, const DataList &dl);
 	ObjectPtr checkCall(const ICM::FuncTableUnit &ftb, const ICM::DataList &dl);
+	// As checkCall, with a result slot owned by the caller.
+	// Return true if the result is written into the slot by funcL,
+	// else the overload is called as checkCall, with the result in op.
+	bool checkCallL(const ICM::FuncTableUnit &ftb, const ICM::DataList &dl, Object* &slot, ObjectPtr &op);
+	// Time the linear scan and the SignTree on the builtins with 4 or more overloads.
+	void benchDispatch();
 	string to_string(const ICM::Function::Signature &sign);
 }
@@ -0,0 +1,200 @@
+#pragma once
+#include "basic.h"
+
+namespace ICM
+{
+	namespace Container
+	{
+		//=======================================
+		// * Hash Functions
+		//=======================================
+		// FNV-1a
+		inline size_t hash_bytes(const void *ptr, size_t len) {
+			const uint8_t *p = static_cast<const uint8_t*>(ptr);
+			uint64_t h = 0xcbf29ce484222325ULL;
+			for (size_t i = 0; i < len; ++i) {
+				h ^= p[i];
+				h *= 0x100000001b3ULL;
+			}
+			return (size_t)h;
+		}
+		// Finalizer of SplitMix64
+		inline size_t hash_mix(uint64_t x) {
+			x ^= x >> 30;
+			x *= 0xbf58476d1ce4e5b9ULL;
+			x ^= x >> 27;
+			x *= 0x94d049bb133111ebULL;
+			x ^= x >> 31;
+			return (size_t)x;
+		}
+		inline size_t hash_combine(size_t seed, size_t h) {
+			return seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+		}
+
+		//=======================================
+		// * Class HashTable
+		//---------------------------------------
+		//   Open addressing with Robin Hood probing.
+		//   The probe metadata is stored apart from the entries,
+		//   so that a probe only walks a compact array.
+		//=======================================
+		template <typename K, typename V, typename Hash, typename Equal>
+		class HashTable
+		{
+		public:
+			using Entry = std::pair<K, V>;
+
+		private:
+			struct Meta
+			{
+				uint32_t dist; // 0 : empty, n : distance from the home bucket + 1
+				uint32_t hash; // Low 32 bits of the hash
+			};
+
+		public:
+			class const_iterator
+			{
+			public:
+				const_iterator(const HashTable *ht, size_t index) : ht(ht), index(index) { skip(); }
+				const Entry& operator*() const { return ht->entries[index]; }
+				const Entry* operator->() const { return &ht->entries[index]; }
+				const_iterator& operator++() { ++index; skip(); return *this; }
+				bool operator==(const const_iterator &ci) const { return index == ci.index; }
+				bool operator!=(const const_iterator &ci) const { return index != ci.index; }
+
+			private:
+				const HashTable *ht;
+				size_t index;
+				void skip() {
+					while (index < ht->meta.size() && ht->meta[index].dist == 0)
+						++index;
+				}
+			};
+
+		public:
+			HashTable() = default;
+
+			size_t size() const { return count; }
+			bool empty() const { return count == 0; }
+			size_t capacity() const { return meta.size(); }
+
+			const_iterator begin() const { return const_iterator(this, 0); }
+			const_iterator end() const { return const_iterator(this, meta.size()); }
+
+			V* find(const K &key) {
+				size_t index = lookup(key);
+				return index == npos ? nullptr : &entries[index].second;
+			}
+			const V* find(const K &key) const {
+				size_t index = lookup(key);
+				return index == npos ? nullptr : &entries[index].second;
+			}
+			bool contains(const K &key) const {
+				return lookup(key) != npos;
+			}
+			// Return true if the key is new.
+			bool insert(const K &key, const V &value) {
+				size_t h = hasher(key);
+				size_t index = lookup(key, h);
+				if (index != npos) {
+					entries[index].second = value;
+					return false;
+				}
+				if ((count + 1) * 8 > meta.size() * 7)
+					rehash(meta.empty() ? 8 : meta.size() * 2);
+				place(Entry(key, value), (uint32_t)h);
+				count++;
+				return true;
+			}
+			// Backward shift deletion, no tombstones.
+			bool erase(const K &key) {
+				size_t index = lookup(key);
+				if (index == npos)
+					return false;
+				size_t next = (index + 1) & mask;
+				while (meta[next].dist > 1) {
+					meta[index] = meta[next];
+					meta[index].dist--;
+					entries[index] = std::move(entries[next]);
+					index = next;
+					next = (next + 1) & mask;
+				}
+				meta[index].dist = 0;
+				entries[index] = Entry();
+				count--;
+				return true;
+			}
+			void reserve(size_t n) {
+				size_t cap = 8;
+				while (cap * 7 < n * 8)
+					cap *= 2;
+				if (cap > meta.size())
+					rehash(cap);
+			}
+			void clear() {
+				meta.clear();
+				entries.clear();
+				count = 0;
+				mask = 0;
+			}
+
+		private:
+			constexpr static size_t npos = MaxValue<size_t>();
+
+			vector<Meta> meta;
+			vector<Entry> entries;
+			size_t count = 0;
+			size_t mask = 0;
+			Hash hasher;
+			Equal equal;
+
+			size_t lookup(const K &key) const {
+				return meta.empty() ? npos : lookup(key, hasher(key));
+			}
+			size_t lookup(const K &key, size_t h) const {
+				if (meta.empty())
+					return npos;
+				uint32_t h32 = (uint32_t)h;
+				size_t index = h32 & mask;
+				for (uint32_t dist = 1; ; ++dist) {
+					const Meta &m = meta[index];
+					// An entry nearer to its home than we are means the key is absent.
+					if (m.dist < dist)
+						return npos;
+					if (m.hash == h32 && equal(entries[index].first, key))
+						return index;
+					index = (index + 1) & mask;
+				}
+			}
+			void place(Entry &&entry, uint32_t h32) {
+				Meta m = { 1, h32 };
+				size_t index = h32 & mask;
+				while (true) {
+					Meta &cur = meta[index];
+					if (cur.dist == 0) {
+						cur = m;
+						entries[index] = std::move(entry);
+						return;
+					}
+					if (cur.dist < m.dist) {
+						std::swap(cur, m);
+						std::swap(entries[index], entry);
+					}
+					m.dist++;
+					index = (index + 1) & mask;
+				}
+			}
+			void rehash(size_t newcap) {
+				vector<Meta> oldmeta(newcap, Meta{ 0, 0 });
+				vector<Entry> oldentries(newcap);
+				oldmeta.swap(meta);
+				oldentries.swap(entries);
+				mask = newcap - 1;
+				for (size_t i : range(0, oldmeta.size())) {
+					if (oldmeta[i].dist != 0)
+						place(std::move(oldentries[i]), oldmeta[i].hash);
+				}
+			}
+		};
+	}
+}
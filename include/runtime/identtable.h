@@ -33,6 +33,7 @@ namespace ICM
 		union {
 			TypeUnit dimtype;  // Dim Type for StVarb
 			TypeUnit restype;  // Restrict Type for DyVarb
+			uint_t FieldIndex; // Offset for Field
 		};
 
 		union {
@@ -41,6 +42,7 @@ namespace ICM
 			Object *Data;
 			size_t FunctionIndex;
 			TypeUnit TypeIndex;
+			size_t StructIndex;
 		};
 	};
 
@@ -0,0 +1,47 @@
+#pragma once
+#include "basic.h"
+#include "runtime/functable.h"
+#include "runtime/caller.h"
+
+namespace ICM
+{
+	//=======================================
+	// * Namespace NativeModule
+	//---------------------------------------
+	//   A shared library loaded by (load-native "path"),
+	//   built against the installed headers:
+	//
+	//     #include "runtime/native.h"
+	//     double vsum(const vector<double> &v) { ... }
+	//     ICM_NATIVE_MODULE(table) {
+	//         table.insert("vsum", ICM::NativeModule::Overloads{ BIND_NATIVE("vsum", vsum) });
+	//     }
+	//
+	//   The functions it inserts are named in the global IdentTable.
+	//   A global variable of the same name, compiled before the load,
+	//   is set to the function.
+	//=======================================
+	namespace NativeModule
+	{
+		// Changed when a module has to be rebuilt for the runtime.
+		constexpr int Version = 1;
+
+		using Overloads = std::initializer_list<Function::FuncInitObject*>;
+		using ModuleFunc = void(FuncTable&);
+		using VersionFunc = int();
+
+		// Return the error message, or an empty string.
+		// A library is loaded once, and never unloaded.
+		string load(const string &path);
+	}
+}
+
+#if defined(_WIN32)
+#define ICM_NATIVE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define ICM_NATIVE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#define ICM_NATIVE_MODULE(_Table) \
+	ICM_NATIVE_EXPORT int icm_native_version() { return ICM::NativeModule::Version; } \
+	ICM_NATIVE_EXPORT void icm_native_module(ICM::FuncTable &_Table)
@@ -0,0 +1,188 @@
+#pragma once
+#include "basic.h"
+
+namespace ICM
+{
+	//=======================================
+	// * Checked Integer Operations
+	//---------------------------------------
+	//   Return true on overflow.
+	//=======================================
+	namespace Checked
+	{
+		inline bool add(int64_t a, int64_t b, int64_t &r) {
+#if defined(__GNUC__)
+			return __builtin_add_overflow(a, b, &r);
+#else
+			r = (int64_t)((uint64_t)a + (uint64_t)b);
+			return ((a ^ r) & (b ^ r)) < 0;
+#endif
+		}
+		inline bool sub(int64_t a, int64_t b, int64_t &r) {
+#if defined(__GNUC__)
+			return __builtin_sub_overflow(a, b, &r);
+#else
+			r = (int64_t)((uint64_t)a - (uint64_t)b);
+			return ((a ^ b) & (a ^ r)) < 0;
+#endif
+		}
+		inline bool mul(int64_t a, int64_t b, int64_t &r) {
+#if defined(__GNUC__)
+			return __builtin_mul_overflow(a, b, &r);
+#else
+			r = (int64_t)((uint64_t)a * (uint64_t)b);
+			return a != 0 && ((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN) || r / a != b);
+#endif
+		}
+	}
+
+	// Binary GCD.
+	uint64_t gcd(uint64_t a, uint64_t b);
+
+	class BigInt;
+	struct BigRational;
+
+	//=======================================
+	// * Class Rational
+	//---------------------------------------
+	//   num/den in lowest terms, with den > 0.
+	//   den == 0 is NaN, the result of division by zero.
+	//   Integers (den == 1) take the fast path.
+	//   Values out of the int64 range are promoted to BigRational
+	//   (den == -1), and demoted again once they fit.
+	//=======================================
+	class Rational
+	{
+	public:
+		Rational() : n(0), d(1) {}
+		Rational(int64_t num) : n(num), d(1) {}
+		Rational(int64_t num, int64_t den);
+
+		static Rational NaN() {
+			Rational r;
+			r.d = 0;
+			return r;
+		}
+		// Accept "123" and "-9/5". Return false on a syntax error.
+		static bool parse(const char *str, Rational &r);
+		// Exact, NaN for infinities and NaN.
+		static Rational from_double(double v);
+
+		// Only meaningful if not isBig().
+		int64_t num() const {
+			return n;
+		}
+		int64_t den() const {
+			return d;
+		}
+		// An integer in the int64 range.
+		bool isInteger() const {
+			return d == 1;
+		}
+		bool isNaN() const {
+			return d == 0;
+		}
+		bool isBig() const {
+			return d == -1;
+		}
+		// Truncated toward zero, and wrapped, for integer types.
+		template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+		explicit operator T() const {
+			return std::is_floating_point<T>::value ? (T)to_double() : (T)(d == 1 ? n : to_int64());
+		}
+		int64_t to_int64() const;
+		double to_double() const;
+		Rational floor() const;
+		Rational trunc() const;
+		size_t hash() const;
+
+		Rational& operator+=(const Rational &r) {
+			int64_t t;
+			if (d == 1 && r.d == 1 && !Checked::add(n, r.n, t)) {
+				n = t;
+				return *this;
+			}
+			return *this = add(*this, r);
+		}
+		Rational& operator-=(const Rational &r) {
+			int64_t t;
+			if (d == 1 && r.d == 1 && !Checked::sub(n, r.n, t)) {
+				n = t;
+				return *this;
+			}
+			return *this = sub(*this, r);
+		}
+		Rational& operator*=(const Rational &r) {
+			int64_t t;
+			if (d == 1 && r.d == 1 && !Checked::mul(n, r.n, t)) {
+				n = t;
+				return *this;
+			}
+			return *this = mul(*this, r);
+		}
+		Rational& operator/=(const Rational &r) {
+			return *this = div(*this, r);
+		}
+		friend Rational operator+(Rational a, const Rational &b) { return a += b; }
+		friend Rational operator-(Rational a, const Rational &b) { return a -= b; }
+		friend Rational operator*(Rational a, const Rational &b) { return a *= b; }
+		friend Rational operator/(Rational a, const Rational &b) { return a /= b; }
+		Rational operator-() const {
+			return Rational() - *this;
+		}
+
+		// NaN is unordered, and unequal to everything.
+		friend bool operator==(const Rational &a, const Rational &b) {
+			if (a.d == -1)
+				return b.d == -1 && equalBig(a, b);
+			return a.d != 0 && a.n == b.n && a.d == b.d;
+		}
+		friend bool operator!=(const Rational &a, const Rational &b) {
+			return !(a == b);
+		}
+		friend bool operator<(const Rational &a, const Rational &b) {
+			if (a.d == 1 && b.d == 1)
+				return a.n < b.n;
+			return compare(a, b) < 0;
+		}
+		friend bool operator>(const Rational &a, const Rational &b) {
+			return b < a;
+		}
+		friend bool operator<=(const Rational &a, const Rational &b) {
+			if (a.d == 1 && b.d == 1)
+				return a.n <= b.n;
+			int c = compare(a, b);
+			return c == 0 || c < 0;
+		}
+		friend bool operator>=(const Rational &a, const Rational &b) {
+			return b <= a;
+		}
+
+		// Floored and truncated remainders.
+		friend Rational mod(const Rational &a, const Rational &b);
+		friend Rational rem(const Rational &a, const Rational &b);
+		friend Rational gcd(const Rational &a, const Rational &b);
+
+		string to_string() const;
+
+	private:
+		int64_t n;
+		int64_t d;
+		std::shared_ptr<const BigRational> big;
+
+		// Normalize, and demote to int64 if it fits. den != 0.
+		static Rational fromBig(BigInt num, BigInt den);
+		static BigRational toBig(const Rational &r);
+		static bool equalBig(const Rational &a, const Rational &b);
+		static Rational negate(const Rational &r);
+
+		static Rational add(const Rational &a, const Rational &b);
+		static Rational sub(const Rational &a, const Rational &b);
+		static Rational mul(const Rational &a, const Rational &b);
+		static Rational div(const Rational &a, const Rational &b);
+		// Return -1, 0, 1, or 2 when unordered.
+		static int compare(const Rational &a, const Rational &b);
+	};
+
+	string to_string(const Rational &r);
+}
@@ -2,6 +2,7 @@
 #include "basic.h"
 #include "parser/objectenum.h"
 #include "objectmanager.h"
+#include "runtime/number.h"
 
 namespace ICM
 {
@@ -35,6 +36,7 @@ namespace ICM
 		using DesFunc = void(DataPointer);
 		using CpyFunc = void(DataPointer, ConstDataPointer);
 		using EquFunc = bool(ConstDataPointer, ConstDataPointer);
+		using HasFunc = size_t(ConstDataPointer);
 		using TosFunc = std::string(ConstDataPointer);
 
 		TypeUnit index;
@@ -45,6 +47,7 @@ namespace ICM
 		DesFunc* destruct;
 		CpyFunc* ncopy;
 		EquFunc* equal;
+		HasFunc* hash;     // nullptr if the type is unhashable.
 
 		TosFunc* to_string;
 		TosFunc* to_output;
@@ -105,6 +108,14 @@ namespace ICM
 			CheckTypeInfo();
 			return this == obj || (this->type == obj->type && TypeInfoTable[type].equal(this->data, obj->data));
 		}
+		bool hashable() const {
+			CheckTypeInfo();
+			return TypeInfoTable[type].hash != nullptr;
+		}
+		size_t hash() const {
+			CheckTypeInfo();
+			return TypeInfoTable[type].hash(data);
+		}
 
 #undef CheckTypeInfo
 
@@ -141,7 +152,7 @@ namespace ICM
 
 		const static bool Value_True;
 		const static bool Value_False;
-		const static uint64_t Value_Zero;
+		const static Rational Value_Zero;
 		
 		Object Null;
 		Object Nil;
@@ -155,9 +166,8 @@ namespace ICM
 	// Types
 	using DataList = lightlist<Object*>;
 	using CallFunc = ObjectPtr(const DataList&);
-	using FuncPtr = std::function<CallFunc>;
+	using FuncPtr = CallFunc*;
 	using LDataList = Common::lightlist<Object*>;
-	using LFuncPtr = std::function<void(Object*&, const LDataList &)>;
 	// Functions
 	template <typename T, typename... Args>
 	inline ObjectPtr createObject(Args... args) {
@@ -26,8 +26,18 @@ namespace ICM
 		DEFTYPE(Keyword, TypeBase::KeywordType);
 		DEFTYPE(Type, TypeBase::TypeType);
 		// List Types
+		DEFTYPE(Array, TypeBase::ArrayType);
 		DEFTYPE(List, TypeBase::ListType);
 		DEFTYPE(Disperse, TypeBase::DisperseType);
+		DEFTYPE(PVector, TypeBase::PVectorType);
+		DEFTYPE(Slice, TypeBase::SliceType);
+		DEFTYPE(Deque, TypeBase::DequeType);
+		DEFTYPE(PQueue, TypeBase::PQueueType);
+		// Map Types
+		DEFTYPE(Map, TypeBase::MapType);
+		DEFTYPE(OrdMap, TypeBase::OrdMapType);
+		// Struct Types
+		DEFTYPE(Struct, TypeBase::StructType);
 		// Compile Types (Platform Dependent)
 		DEFTYPE(Int, int_t);
 		DEFTYPE(UInt, uint_t);
@@ -85,19 +95,60 @@ namespace ICM
 			DataObject(const T &dat) : Object(_Type) { this->data = new T(dat); }
 		};
 		
+		//=======================================
+		// * Function resultSlot<_Type>
+		//---------------------------------------
+		//   The data of the result slot as a _Type.
+		//   The slot is null or owned by the caller,
+		//   and is replaced by a new object if it has another type.
+		//=======================================
+		template <DefaultType _Type>
+		typename TType<_Type>::Type& resultSlot(Object* &result) {
+			if (!result || result->type != _Type)
+				result = new DataObject<_Type>();
+			return result->dat<_Type>();
+		}
+
+		//=======================================
+		// * Function newObjects<_Type>
+		//---------------------------------------
+		//   n objects of _Type, with their data in one block.
+		//   For results of batch calls, as objects are never freed.
+		//=======================================
+		template <DefaultType _Type>
+		Object* newObjects(size_t n) {
+			using T = typename TType<_Type>::Type;
+			Object *ops = new Object[n];
+			T *data = new T[n];
+			for (size_t i : range(0, n)) {
+				ops[i].type = _Type;
+				ops[i].data = data + i;
+			}
+			return ops;
+		}
+
 		using Nil = DataObject<T_Nil>;
 		using Error = DataObject<T_Error>;
 		using Boolean = DataObject<T_Boolean>;
 		using Number = DataObject<T_Number>;
 		using String = DataObject<T_String>;
 
+		using Array = DataObject<T_Array>;
 		using List = DataObject<T_List>;
 		using Disperse = DataObject<T_Disperse>;
+		using PVector = DataObject<T_PVector>;
+		using Slice = DataObject<T_Slice>;
+		using Deque = DataObject<T_Deque>;
+		using PQueue = DataObject<T_PQueue>;
+		using Map = DataObject<T_Map>;
+		using OrdMap = DataObject<T_OrdMap>;
+		using Struct = DataObject<T_Struct>;
 		using Keyword = DataObject<T_Keyword>;
 		using Function = DataObject<T_Function>;
 		using Type = DataObject<T_Type>;
+		using Double = DataObject<T_Double>;
 
-		vector<Object*>::iterator begin(Disperse *disp);
-		vector<Object*>::iterator end(Disperse *disp);
+		TypeBase::DisperseType::const_iterator begin(Disperse *disp);
+		TypeBase::DisperseType::const_iterator end(Disperse *disp);
 	}
 }
@@ -92,6 +92,10 @@ namespace ICM
 		ObjectPtr(std::nullptr_t) : data(nullptr) {}
 		ObjectPtr(Object *obj) : data(obj) {}
 		ObjectPtr(const ObjectPtr &op) : data(op.data) {}
+		ObjectPtr& operator=(const ObjectPtr &op) {
+			data = op.data;
+			return *this;
+		}
 
 		Object* get() const {
 			return data;
@@ -0,0 +1,176 @@
+#pragma once
+#include "basic.h"
+#include <array>
+
+namespace ICM
+{
+	namespace Container
+	{
+		//=======================================
+		// * Class PersistentVector
+		//---------------------------------------
+		//   A 32-way trie of leaves, with the last leaf (the tail)
+		//   kept out of the trie. Nodes are never modified, so an
+		//   update copies only the path to the changed leaf,
+		//   and shares everything else with the original.
+		//=======================================
+		template <typename T>
+		class PersistentVector
+		{
+			constexpr static size_t Bits = 5;
+			constexpr static size_t Width = 1 << Bits;
+			constexpr static size_t Mask = Width - 1;
+
+			struct Node {};
+			using NodePtr = std::shared_ptr<const Node>;
+			struct Branch : public Node {
+				std::array<NodePtr, Width> child;
+			};
+			struct Leaf : public Node {
+				std::array<T, Width> value;
+			};
+			using LeafPtr = std::shared_ptr<const Leaf>;
+
+		public:
+			PersistentVector() : root(std::make_shared<Branch>()), tail(std::make_shared<Leaf>()) {}
+
+			template <typename It>
+			static PersistentVector from(It begin, It end) {
+				PersistentVector pv;
+				while (begin != end) {
+					auto leaf = std::make_shared<Leaf>();
+					size_t n = 0;
+					for (; n < Width && begin != end; ++n, ++begin)
+						leaf->value[n] = *begin;
+					if (n == Width && begin != end) {
+						pv.count += Width;
+						pv.pushLeaf(leaf);
+					}
+					else {
+						pv.tail = leaf;
+						pv.count += n;
+					}
+				}
+				return pv;
+			}
+
+			size_t size() const {
+				return count;
+			}
+			bool empty() const {
+				return count == 0;
+			}
+			const T& operator[](size_t index) const {
+				assert(index < count);
+				return leafFor(index)[index & Mask];
+			}
+			// Call f on each element in order, a leaf at a time.
+			template <typename F>
+			void for_each(F f) const {
+				for (size_t i = 0; i < count; i += Width) {
+					const T *leaf = leafFor(i);
+					size_t n = count - i < Width ? count - i : Width;
+					for (size_t j : range(0, n))
+						f(leaf[j]);
+				}
+			}
+
+			// index <= size(), and index == size() appends.
+			PersistentVector assoc(size_t index, const T &v) const {
+				assert(index <= count);
+				if (index == count)
+					return conj(v);
+				PersistentVector pv = *this;
+				if (index >= tailOffset()) {
+					auto leaf = std::make_shared<Leaf>(*tail);
+					leaf->value[index & Mask] = v;
+					pv.tail = leaf;
+				}
+				else {
+					pv.root = assocNode(shift, root, index, v);
+				}
+				return pv;
+			}
+			PersistentVector conj(const T &v) const {
+				PersistentVector pv = *this;
+				if (count - tailOffset() < Width) {
+					auto leaf = std::make_shared<Leaf>(*tail);
+					leaf->value[count - tailOffset()] = v;
+					pv.tail = leaf;
+				}
+				else {
+					pv.pushLeaf(tail);
+					auto leaf = std::make_shared<Leaf>();
+					leaf->value[0] = v;
+					pv.tail = leaf;
+				}
+				pv.count++;
+				return pv;
+			}
+
+		private:
+			size_t count = 0;
+			size_t shift = Bits;
+			NodePtr root;
+			LeafPtr tail;
+
+			// Index of the first element in the tail.
+			size_t tailOffset() const {
+				return count < Width ? 0 : ((count - 1) >> Bits) << Bits;
+			}
+			const T* leafFor(size_t index) const {
+				if (index >= tailOffset())
+					return tail->value.data();
+				const Node *node = root.get();
+				for (size_t level = shift; level > 0; level -= Bits)
+					node = static_cast<const Branch*>(node)->child[(index >> level) & Mask].get();
+				return static_cast<const Leaf*>(node)->value.data();
+			}
+			// Put a full leaf into the trie, as the one before the tail.
+			// count is not changed, and counts the elements in the trie plus the leaf.
+			void pushLeaf(const LeafPtr &leaf) {
+				size_t index = count - 1;
+				if ((index >> Bits) >= ((size_t)1 << shift)) {
+					// The root is full, grow a level.
+					auto branch = std::make_shared<Branch>();
+					branch->child[0] = root;
+					branch->child[1] = newPath(shift, leaf);
+					root = branch;
+					shift += Bits;
+				}
+				else {
+					root = pushLeaf(shift, root, index, leaf);
+				}
+			}
+			static NodePtr pushLeaf(size_t level, const NodePtr &node, size_t index, const LeafPtr &leaf) {
+				auto branch = std::make_shared<Branch>(*static_cast<const Branch*>(node.get()));
+				size_t sub = (index >> level) & Mask;
+				if (level == Bits)
+					branch->child[sub] = leaf;
+				else if (branch->child[sub])
+					branch->child[sub] = pushLeaf(level - Bits, branch->child[sub], index, leaf);
+				else
+					branch->child[sub] = newPath(level - Bits, leaf);
+				return branch;
+			}
+			static NodePtr newPath(size_t level, const LeafPtr &leaf) {
+				if (level == 0)
+					return leaf;
+				auto branch = std::make_shared<Branch>();
+				branch->child[0] = newPath(level - Bits, leaf);
+				return branch;
+			}
+			static NodePtr assocNode(size_t level, const NodePtr &node, size_t index, const T &v) {
+				if (level == 0) {
+					auto leaf = std::make_shared<Leaf>(*static_cast<const Leaf*>(node.get()));
+					leaf->value[index & Mask] = v;
+					return leaf;
+				}
+				auto branch = std::make_shared<Branch>(*static_cast<const Branch*>(node.get()));
+				size_t sub = (index >> level) & Mask;
+				branch->child[sub] = assocNode(level - Bits, branch->child[sub], index, v);
+				return branch;
+			}
+		};
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "basic.h"
+
+namespace ICM
+{
+	//=======================================
+	// * Class RandomEngine
+	//---------------------------------------
+	//   xoshiro256** by Blackman and Vigna.
+	//   The state is filled from the seed by splitmix64,
+	//   so any seed, 0 included, is fine.
+	//=======================================
+	class RandomEngine
+	{
+	public:
+		explicit RandomEngine(uint64_t seed) {
+			this->seed(seed);
+		}
+
+		void seed(uint64_t seed);
+		uint64_t next() {
+			uint64_t result = rotl(s[1] * 5, 7) * 9;
+			uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = rotl(s[3], 45);
+			return result;
+		}
+		// Uniform in [0, bound), bound > 0.
+		// Draws below 2^64 mod bound are rejected, so there is no bias.
+		uint64_t below(uint64_t bound) {
+			uint64_t threshold = (0 - bound) % bound;
+			while (true) {
+				uint64_t r = next();
+				if (r >= threshold)
+					return r % bound;
+			}
+		}
+
+	private:
+		uint64_t s[4];
+
+		static uint64_t rotl(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		}
+	};
+
+	// Seeded from the clock at startup, and by (seed n).
+	extern RandomEngine GlobalRandom;
+}
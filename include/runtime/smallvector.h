@@ -0,0 +1,168 @@
+#pragma once
+#include "basic.h"
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+namespace ICM
+{
+	namespace Container
+	{
+		//=======================================
+		// * Class SmallVector
+		//---------------------------------------
+		//   A vector keeping up to N elements inline,
+		//   and moving them to the heap when it grows past N.
+		//   Only for trivially copyable types, such as pointers.
+		//=======================================
+		template <typename T, size_t N>
+		class SmallVector
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "SmallVector holds trivially copyable types only.");
+		public:
+			using value_type = T;
+			using iterator = T*;
+			using const_iterator = const T*;
+
+			SmallVector() {}
+			template <typename It>
+			SmallVector(It begin, It end) {
+				insert(this->end(), begin, end);
+			}
+			SmallVector(const SmallVector &sv) : SmallVector(sv.begin(), sv.end()) {}
+			SmallVector(SmallVector &&sv) {
+				moveFrom(sv);
+			}
+			~SmallVector() {
+				release();
+			}
+			SmallVector& operator=(const SmallVector &sv) {
+				if (this != &sv) {
+					count = 0;
+					insert(end(), sv.begin(), sv.end());
+				}
+				return *this;
+			}
+			SmallVector& operator=(SmallVector &&sv) {
+				if (this != &sv) {
+					release();
+					moveFrom(sv);
+				}
+				return *this;
+			}
+
+			size_t size() const {
+				return count;
+			}
+			size_t capacity() const {
+				return cap;
+			}
+			bool empty() const {
+				return count == 0;
+			}
+			T* data() {
+				return ptr;
+			}
+			const T* data() const {
+				return ptr;
+			}
+			iterator begin() {
+				return ptr;
+			}
+			iterator end() {
+				return ptr + count;
+			}
+			const_iterator begin() const {
+				return ptr;
+			}
+			const_iterator end() const {
+				return ptr + count;
+			}
+			T& operator[](size_t index) {
+				assert(index < count);
+				return ptr[index];
+			}
+			const T& operator[](size_t index) const {
+				assert(index < count);
+				return ptr[index];
+			}
+
+			void reserve(size_t length) {
+				if (length > cap)
+					regrow(length, end(), end(), count);
+			}
+			void push_back(const T &v) {
+				if (count == cap) {
+					// v may be in this vector.
+					T t = v;
+					reserve(cap * 2);
+					ptr[count++] = t;
+				}
+				else {
+					ptr[count++] = v;
+				}
+			}
+			// [first, last) may be in this vector when inserting at the end.
+			template <typename It>
+			iterator insert(const_iterator pos, It first, It last) {
+				size_t offset = pos - ptr;
+				size_t n = std::distance(first, last);
+				if (count + n > cap) {
+					regrow(std::max(count + n, cap * 2), first, last, offset);
+				}
+				else {
+					std::copy_backward(ptr + offset, ptr + count, ptr + count + n);
+					std::copy(first, last, ptr + offset);
+				}
+				count += n;
+				return ptr + offset;
+			}
+			void clear() {
+				count = 0;
+			}
+
+		private:
+			T *ptr = local;
+			size_t count = 0;
+			size_t cap = N;
+			T local[N];
+
+			bool isInline() const {
+				return ptr == local;
+			}
+			void release() {
+				if (!isInline())
+					delete[] ptr;
+				ptr = local;
+				count = 0;
+				cap = N;
+			}
+			void moveFrom(SmallVector &sv) {
+				if (sv.isInline()) {
+					std::copy(sv.begin(), sv.end(), local);
+				}
+				else {
+					ptr = sv.ptr;
+					cap = sv.cap;
+					sv.ptr = sv.local;
+					sv.cap = N;
+				}
+				count = sv.count;
+				sv.count = 0;
+			}
+			// Move to a buffer of length, with [first, last) inserted at offset.
+			// count is not changed. The old buffer is freed after the copy.
+			template <typename It>
+			void regrow(size_t length, It first, It last, size_t offset) {
+				T *p = new T[length];
+				T *e = std::copy(ptr, ptr + offset, p);
+				e = std::copy(first, last, e);
+				std::copy(ptr + offset, ptr + count, e);
+				if (!isInline())
+					delete[] ptr;
+				ptr = p;
+				cap = length;
+			}
+		};
+	}
+}
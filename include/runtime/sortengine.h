@@ -0,0 +1,90 @@
+#pragma once
+#include "basic.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace ICM
+{
+	//=======================================
+	// * SortEngine
+	//---------------------------------------
+	//   Sorting of large arrays. Integer and Double keys are
+	//   radix sorted, other elements are compared.
+	//   Large arrays are sorted in chunks on several threads,
+	//   and the chunks merged.
+	//=======================================
+	namespace SortEngine
+	{
+		// Below this, comparison sorts are faster than radix sorts.
+		constexpr size_t RadixMin = 1024;
+		// The least elements a thread is given.
+		constexpr size_t ChunkMin = 1 << 16;
+
+		// An element with the key it is ordered by.
+		struct Keyed
+		{
+			uint64_t key;
+			void *item;
+		};
+
+		// Keys compared as unsigned are in the order of the values.
+		inline uint64_t key(int64_t v) {
+			return (uint64_t)v ^ (1ull << 63);
+		}
+		// v should not be NaN.
+		inline uint64_t key(double v) {
+			uint64_t bits;
+			std::memcpy(&bits, &v, sizeof(bits));
+			return (bits & (1ull << 63)) ? ~bits : bits | (1ull << 63);
+		}
+
+		// The number of chunks for n elements, a power of two.
+		size_t chunks(size_t n);
+		// Call task(i) for i in [0, count), each on its own thread.
+		void parallel(size_t count, const std::function<void(size_t)> &task);
+		// LSD radix sort by key. Stable.
+		void radix(Keyed *data, size_t n);
+
+		// Sort each chunk with sortChunk(begin, end), then merge them by less.
+		// The result is stable if sortChunk is.
+		template <typename T, typename SortChunk, typename Less>
+		void sortChunks(T *data, size_t n, SortChunk sortChunk, Less less) {
+			size_t count = chunks(n);
+			if (count == 1) {
+				sortChunk(data, data + n);
+				return;
+			}
+			auto bound = [&](size_t i) { return n * i / count; };
+			parallel(count, [&](size_t i) {
+				sortChunk(data + bound(i), data + bound(i + 1));
+			});
+
+			vector<T> buffer(n);
+			T *from = data, *to = buffer.data();
+			for (size_t width = 1; width < count; width *= 2) {
+				parallel(count / (width * 2), [&](size_t i) {
+					size_t b = bound(i * width * 2), m = bound(i * width * 2 + width), e = bound(i * width * 2 + width * 2);
+					std::merge(from + b, from + m, from + m, from + e, to + b, less);
+				});
+				std::swap(from, to);
+			}
+			if (from != data)
+				std::copy(from, from + n, data);
+		}
+
+		// Sort by less, with std::sort or std::stable_sort for each chunk.
+		template <typename T, typename Less>
+		void sort(T *data, size_t n, Less less, bool stable) {
+			if (stable)
+				sortChunks(data, n, [&](T *b, T *e) { std::stable_sort(b, e, less); }, less);
+			else
+				sortChunks(data, n, [&](T *b, T *e) { std::sort(b, e, less); }, less);
+		}
+
+		// Sort by key. Stable.
+		inline void sortKeyed(Keyed *data, size_t n) {
+			sortChunks(data, n, [](Keyed *b, Keyed *e) { radix(b, e - b); }, [](const Keyed &a, const Keyed &b) { return a.key < b.key; });
+		}
+	}
+}
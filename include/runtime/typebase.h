@@ -4,6 +4,11 @@
 #include "parser/literal.h"
 #include "runtime/object.h"
 #include "runtime/functable.h"
+#include "runtime/hashtable.h"
+#include "runtime/pvector.h"
+#include "runtime/smallvector.h"
+#include "runtime/deque.h"
+#include "runtime/btree.h"
 
 namespace ICM
 {
@@ -24,6 +29,8 @@ namespace ICM
 		string to_string_code(const T &t) {
 			return to_string<T>(t);
 		}
+		// The shortest digits that read back the same value.
+		template <> string to_string<double>(const double &v);
 
 		class VoidType {
 		public:
@@ -65,15 +72,23 @@ namespace ICM
 
 		//=======================================
 		// * Class ListType
+		//---------------------------------------
+		//   Most lists are short, pairs and the like,
+		//   so the first few elements are kept inline.
 		//=======================================
 		class ListType
 		{
-			using DataList = vector<Object*>;
 		public:
+			using DataList = Container::SmallVector<Object*, 4>;
+
 			ListType() {}
 			explicit ListType(const lightlist<Object*> &dl) : data(dl.begin(), dl.end()) {}
-			explicit ListType(const DataList &dl) : data(dl) {}
+			explicit ListType(const vector<Object*> &dl) : data(dl.begin(), dl.end()) {}
 			ListType(const ListType &lt) : data(lt.data) {}
+			ListType& operator=(const ListType &lt) {
+				data = lt.data;
+				return *this;
+			}
 
 			ListType* push(Object* objp);
 			ListType* push(const DataList &dl);
@@ -87,6 +102,9 @@ namespace ICM
 			const DataList& getData() const {
 				return data;
 			}
+			Object* at(size_t index) const {
+				return data[index];
+			}
 			size_t size() const {
 				return data.size();
 			}
@@ -96,10 +114,11 @@ namespace ICM
 			void reserve(size_t length) {
 				data.reserve(length);
 			}
-			// Method
-			bool operator==(const ListType &lt) const {
-				return this->data == lt.data;
+			void clear() {
+				data.clear();
 			}
+			// Method
+			bool operator==(const ListType &lt) const;
 			string to_string() const;
 			string to_output() const;
 
@@ -109,39 +128,525 @@ namespace ICM
 		template <> string to_string<ListType>(const ListType &lt);
 		template <> string to_output<ListType>(const ListType &lt);
 
+		//=======================================
+		// * Class SliceType
+		//---------------------------------------
+		//   A view of every stride-th element of a list,
+		//   reading and writing through the storage of the list.
+		//=======================================
+		class SliceType
+		{
+		public:
+			SliceType() {}
+			SliceType(ListType &lt, size_t offset, size_t length, ptrdiff_t stride)
+				: source(&lt), offset(offset), length(length), stride(stride) {}
+
+			size_t size() const {
+				return length;
+			}
+			Object* at(size_t index) const {
+				return source->at(position(index));
+			}
+			void set(size_t index, Object *op) {
+				*(source->begin() + position(index)) = op;
+			}
+			// A slice of this slice, viewing the same list.
+			SliceType slice(size_t begin, size_t length, ptrdiff_t stride) const {
+				return SliceType(*source, position(begin), length, this->stride * stride);
+			}
+			ListType to_list() const;
+			// Method
+			bool operator==(const SliceType &st) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			ListType *source = nullptr;
+			size_t offset = 0;
+			size_t length = 0;
+			ptrdiff_t stride = 1;
+
+			size_t position(size_t index) const {
+				return (size_t)((ptrdiff_t)offset + (ptrdiff_t)index * stride);
+			}
+		};
+		template <> string to_string<SliceType>(const SliceType &st);
+		template <> string to_output<SliceType>(const SliceType &st);
+
+		//=======================================
+		// * Class ArrayType
+		//---------------------------------------
+		//   Unboxed elements of one numeric type,
+		//   kept in a contiguous buffer.
+		//=======================================
+		class ArrayType
+		{
+			using Word = uint64_t;
+		public:
+			explicit ArrayType(TypeUnit elemtype = T_Int64) : elemtype(elemtype), esize(elemSize(elemtype)) {}
+
+			static bool isElemType(TypeUnit type);
+			static size_t elemSize(TypeUnit type);
+			static bool isFloatType(TypeUnit type) {
+				return type == T_Float || type == T_Double;
+			}
+
+			TypeUnit getElemType() const {
+				return elemtype;
+			}
+			size_t size() const {
+				return length;
+			}
+			size_t capacity() const {
+				return buffer.size() * sizeof(Word) / esize;
+			}
+			void reserve(size_t n) {
+				buffer.reserve((n * esize + sizeof(Word) - 1) / sizeof(Word));
+			}
+			void resize(size_t n) {
+				buffer.resize((n * esize + sizeof(Word) - 1) / sizeof(Word));
+				length = n;
+			}
+			template <typename T> T* data() {
+				return reinterpret_cast<T*>(buffer.data());
+			}
+			template <typename T> const T* data() const {
+				return reinterpret_cast<const T*>(buffer.data());
+			}
+			// Call f with a typed pointer to the elements.
+			template <typename F> void visit(F f);
+			template <typename F> void visit(F f) const;
+
+			// Boxing/Unboxing
+			Object* get(size_t index) const;
+			bool set(size_t index, const Object *op);
+			bool push(const Object *op);
+			void sort();
+			// Method
+			bool operator==(const ArrayType &at) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			TypeUnit elemtype;
+			size_t esize;
+			size_t length = 0;
+			vector<Word> buffer;
+		};
+		template <> string to_string<ArrayType>(const ArrayType &at);
+		template <> string to_output<ArrayType>(const ArrayType &at);
+
+#define ARRAY_VISIT_CASES(_ptr) \
+	case T_Int:    f(_ptr<int_t>()); break; \
+	case T_UInt:   f(_ptr<uint_t>()); break; \
+	case T_Float:  f(_ptr<float>()); break; \
+	case T_Double: f(_ptr<double>()); break; \
+	case T_Byte:   f(_ptr<uint8_t>()); break; \
+	case T_Word:   f(_ptr<uint16_t>()); break; \
+	case T_DWord:  f(_ptr<uint32_t>()); break; \
+	case T_QWord:  f(_ptr<uint64_t>()); break; \
+	case T_Int8:   f(_ptr<int8_t>()); break; \
+	case T_Int16:  f(_ptr<int16_t>()); break; \
+	case T_Int32:  f(_ptr<int32_t>()); break; \
+	case T_Int64:  f(_ptr<int64_t>()); break; \
+	case T_UInt8:  f(_ptr<uint8_t>()); break; \
+	case T_UInt16: f(_ptr<uint16_t>()); break; \
+	case T_UInt32: f(_ptr<uint32_t>()); break; \
+	case T_UInt64: f(_ptr<uint64_t>()); break; \
+	default: assert(false);
+
+		template <typename F> void ArrayType::visit(F f) {
+			switch (elemtype) {
+				ARRAY_VISIT_CASES(data)
+			}
+		}
+		template <typename F> void ArrayType::visit(F f) const {
+			switch (elemtype) {
+				ARRAY_VISIT_CASES(data)
+			}
+		}
+#undef ARRAY_VISIT_CASES
+
 		//=======================================
 		// * Class DisperseType
+		//---------------------------------------
+		//   A view of the elements of a list, spread into a call.
+		//   It borrows them from the list without copying.
+		//   The view keeps the length the list had, and is cut
+		//   to the list if elements are removed from it since.
 		//=======================================
 		class DisperseType
 		{
-			using DataList = vector<Object*>;
+			using DataList = ListType::DataList;
 		public:
+			using const_iterator = Object* const*;
+
 			DisperseType() {}
-			explicit DisperseType(const lightlist<Object*> &dl) : data(dl.begin(), dl.end()) {}
-			explicit DisperseType(const DataList &dl) : data(dl) {}
+			explicit DisperseType(const ListType &lt) : source(&lt.getData()), length(lt.size()) {}
 
-			DataList::iterator begin() {
-				return data.begin();
+			// Read through the list, which may have been reallocated since.
+			const_iterator begin() const {
+				return source ? source->data() : nullptr;
 			}
-			DataList::iterator end() {
-				return data.end();
+			const_iterator end() const {
+				return begin() + size();
 			}
-			const DataList& getData() const {
-				return data;
+			size_t size() const {
+				return source ? std::min(length, source->size()) : 0;
 			}
 			// Method
-			bool operator==(const DisperseType &lt) const {
-				return this->data == lt.data;
+			bool operator==(const DisperseType &dt) const {
+				return size() == dt.size() && std::equal(begin(), end(), dt.begin());
 			}
 			string to_string() const;
 			string to_output() const;
 
 		private:
-			DataList data;
+			const DataList *source = nullptr;
+			size_t length = 0;
 		};
 		template <> string to_string<DisperseType>(const DisperseType &dt);
 		template <> string to_output<DisperseType>(const DisperseType &dt);
 
+		//=======================================
+		// * Class PVectorType
+		//---------------------------------------
+		//   Persistent, an update returns a new vector
+		//   sharing most of its structure with the old one.
+		//=======================================
+		class PVectorType
+		{
+			using Data = Container::PersistentVector<Object*>;
+		public:
+			PVectorType() {}
+			explicit PVectorType(const ListType &lt) : data(Data::from(lt.getData().begin(), lt.getData().end())) {}
+
+			size_t size() const {
+				return data.size();
+			}
+			Object* at(size_t index) const {
+				return data[index];
+			}
+			PVectorType assoc(size_t index, Object *op) const {
+				return PVectorType(data.assoc(index, op));
+			}
+			PVectorType conj(Object *op) const {
+				return PVectorType(data.conj(op));
+			}
+			ListType to_list() const;
+			// Method
+			bool operator==(const PVectorType &pv) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			Data data;
+
+			explicit PVectorType(Data &&data) : data(std::move(data)) {}
+		};
+		template <> string to_string<PVectorType>(const PVectorType &pv);
+		template <> string to_output<PVectorType>(const PVectorType &pv);
+
+		//=======================================
+		// * Class DequeType
+		//=======================================
+		class DequeType
+		{
+			using Data = Container::Deque<Object*>;
+		public:
+			DequeType() {}
+			explicit DequeType(const ListType &lt);
+
+			size_t size() const {
+				return data.size();
+			}
+			bool empty() const {
+				return data.empty();
+			}
+			Object* at(size_t index) const {
+				return data[index];
+			}
+			void set(size_t index, Object *op) {
+				data[index] = op;
+			}
+			Object* front() const {
+				return data[0];
+			}
+			Object* back() const {
+				return data[data.size() - 1];
+			}
+			void push_front(Object *op) {
+				data.push_front(op);
+			}
+			void push_back(Object *op) {
+				data.push_back(op);
+			}
+			Object* pop_front() {
+				return data.pop_front();
+			}
+			Object* pop_back() {
+				return data.pop_back();
+			}
+			ListType to_list() const;
+			// Method
+			bool operator==(const DequeType &dt) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			Data data;
+		};
+		template <> string to_string<DequeType>(const DequeType &dt);
+		template <> string to_output<DequeType>(const DequeType &dt);
+
+		//=======================================
+		// * Class PQueueType
+		//---------------------------------------
+		//   Values by numeric priority, the least first.
+		//   Priorities are ordered by their exact values, so that
+		//   Numbers, Doubles and fixed-width integers mix.
+		//   Infinities are ranked before or after the exact values.
+		//   Values of the same priority come out in the order they went in.
+		//=======================================
+		class PQueueType
+		{
+			struct Entry {
+				int rank;
+				NumberType key;
+				Object *priority;
+				size_t order;
+				Object *value;
+			};
+			struct Less {
+				bool operator()(const Entry &a, const Entry &b) const {
+					if (a.rank != b.rank)
+						return a.rank < b.rank;
+					if (a.key == b.key)
+						return a.order < b.order;
+					return a.key < b.key;
+				}
+			};
+			using Data = Container::BinaryHeap<Entry, Less>;
+		public:
+			PQueueType() {}
+
+			size_t size() const {
+				return data.size();
+			}
+			bool empty() const {
+				return data.empty();
+			}
+			Object* topPriority() const {
+				return data.top().priority;
+			}
+			Object* top() const {
+				return data.top().value;
+			}
+			// rank is -1 for -inf, 1 for inf, and 0 for a finite priority,
+			// whose exact value is key. key is not NaN.
+			void push(int rank, const NumberType &key, Object *priority, Object *op) {
+				data.push(Entry{ rank, key, priority, order++, op });
+			}
+			Object* pop() {
+				return data.pop().value;
+			}
+			ListType to_list() const;
+			// Method
+			bool operator==(const PQueueType &pq) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			Data data;
+			size_t order = 0;
+		};
+		template <> string to_string<PQueueType>(const PQueueType &pq);
+		template <> string to_output<PQueueType>(const PQueueType &pq);
+
+		//=======================================
+		// * Class MapType
+		//=======================================
+		class MapType
+		{
+			struct Hash {
+				size_t operator()(Object *op) const { return op->hash(); }
+			};
+			struct Equal {
+				bool operator()(Object *a, Object *b) const { return a->equ(b); }
+			};
+			using Table = Container::HashTable<Object*, Object*, Hash, Equal>;
+		public:
+			using const_iterator = Table::const_iterator;
+
+			MapType() {}
+
+			// Keys should be hashable.
+			Object* find(Object *key) const {
+				Object* const *p = data.find(key);
+				return p ? *p : nullptr;
+			}
+			bool contains(Object *key) const {
+				return data.contains(key);
+			}
+			void insert(Object *key, Object *value);
+			bool erase(Object *key) {
+				return data.erase(key);
+			}
+			size_t size() const {
+				return data.size();
+			}
+			void reserve(size_t length) {
+				data.reserve(length);
+			}
+			const_iterator begin() const {
+				return data.begin();
+			}
+			const_iterator end() const {
+				return data.end();
+			}
+			// Method
+			bool operator==(const MapType &mt) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			Table data;
+		};
+		template <> string to_string<MapType>(const MapType &mt);
+		template <> string to_output<MapType>(const MapType &mt);
+
+		//=======================================
+		// * Class OrdMapType
+		//---------------------------------------
+		//   A map ordered by key, in a B+ tree.
+		//   Keys are Numbers, Strings or Symbols;
+		//   Numbers sort before Strings, and Strings before Symbols.
+		//=======================================
+		class OrdMapType
+		{
+			struct Less {
+				bool operator()(Object *a, Object *b) const { return compareKey(a, b) < 0; }
+			};
+			using Tree = Container::BTree<Object*, Object*, Less>;
+		public:
+			using const_iterator = Tree::const_iterator;
+
+			OrdMapType() {}
+
+			static bool isKey(const Object *op);
+			// Return -1, 0 or 1. Both are keys.
+			static int compareKey(const Object *a, const Object *b);
+			// Replace the entries in O(n), if the keys are strictly increasing.
+			// Return false if not, and the map is unchanged.
+			bool assign_sorted(const vector<std::pair<Object*, Object*>> &entries);
+
+			Object* find(Object *key) const {
+				Object* const *p = data.find(key);
+				return p ? *p : nullptr;
+			}
+			bool contains(Object *key) const {
+				return data.find(key) != nullptr;
+			}
+			void insert(Object *key, Object *value);
+			bool erase(Object *key) {
+				return data.erase(key);
+			}
+			size_t size() const {
+				return data.size();
+			}
+			const_iterator begin() const {
+				return data.begin();
+			}
+			const_iterator end() const {
+				return data.end();
+			}
+			const_iterator lower_bound(Object *key) const {
+				return data.lower_bound(key);
+			}
+			// Method
+			bool operator==(const OrdMapType &mt) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			Tree data;
+		};
+		template <> string to_string<OrdMapType>(const OrdMapType &mt);
+		template <> string to_output<OrdMapType>(const OrdMapType &mt);
+
+		//=======================================
+		// * Struct StructInfo
+		//---------------------------------------
+		//   The layout of a defstruct, the offset of
+		//   a field is its index in fields.
+		//=======================================
+		struct StructInfo
+		{
+			string name;
+			vector<string> fields;
+		};
+
+		//=======================================
+		// * Class StructType
+		//---------------------------------------
+		//   A record, the slots follow the header
+		//   in a single allocation.
+		//=======================================
+		class StructType
+		{
+			struct Header {
+				size_t id;
+				size_t size;
+			};
+		public:
+			StructType() {}
+			// The slots are initialized to nil.
+			explicit StructType(size_t id);
+			StructType(const StructType &st);
+			StructType(StructType &&st) : block(st.block) {
+				st.block = nullptr;
+			}
+			~StructType() {
+				::operator delete(block);
+			}
+			StructType& operator=(StructType st) {
+				std::swap(block, st.block);
+				return *this;
+			}
+
+			size_t getID() const {
+				return block->id;
+			}
+			const StructInfo& getInfo() const;
+			size_t size() const {
+				return block ? block->size : 0;
+			}
+			Object* get(size_t offset) const {
+				assert(offset < size());
+				return slots()[offset];
+			}
+			void set(size_t offset, Object *op) {
+				assert(offset < size());
+				slots()[offset] = op;
+			}
+			// Method
+			bool operator==(const StructType &st) const;
+			string to_string() const;
+			string to_output() const;
+
+		private:
+			Header *block = nullptr;
+
+			Object** slots() const {
+				return reinterpret_cast<Object**>(block + 1);
+			}
+			static Header* allocate(size_t id, size_t size);
+		};
+		template <> string to_string<StructType>(const StructType &st);
+		template <> string to_output<StructType>(const StructType &st);
+
+		extern vector<StructInfo> GlobalStructTable;
+
 		//=======================================
 		// * Class Error
 		//=======================================
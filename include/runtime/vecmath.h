@@ -0,0 +1,47 @@
+#pragma once
+#include "basic.h"
+
+namespace ICM
+{
+	//=======================================
+	// * VecMath
+	//---------------------------------------
+	//   Element-wise kernels over unboxed numbers.
+	//   The AVX2 versions are chosen at runtime when the CPU supports them.
+	//=======================================
+	namespace VecMath
+	{
+		enum Operator { Add, Sub, Mul, Div, Min, Max };
+		enum Compare { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+		bool hasAVX2();
+
+		// sa/sb is 1 for a vector operand, and 0 to broadcast a scalar operand.
+		// Return false on integer overflow or division by zero.
+		bool calc(Operator op, const int64_t *a, size_t sa, const int64_t *b, size_t sb, int64_t *r, size_t n);
+		bool calc(Operator op, const double *a, size_t sa, const double *b, size_t sb, double *r, size_t n);
+
+		// Write 1 to r[i] if the comparison holds, otherwise 0.
+		void compare(Compare op, const int64_t *a, size_t sa, const int64_t *b, size_t sb, uint8_t *r, size_t n);
+		void compare(Compare op, const double *a, size_t sa, const double *b, size_t sb, uint8_t *r, size_t n);
+
+		// Reductions
+		// Integer versions return false if the result is out of range.
+		// Intermediate overflow is fine, the running sum is kept in 128 bits.
+		bool sum(const int64_t *a, size_t n, int64_t &r);
+		double sum(const double *a, size_t n);
+		// Correctly rounded sum of doubles (Shewchuk's algorithm).
+		double sum_exact(const double *a, size_t n);
+		bool product(const int64_t *a, size_t n, int64_t &r);
+		double product(const double *a, size_t n);
+		// n should be greater than 0.
+		int64_t min(const int64_t *a, size_t n);
+		double min(const double *a, size_t n);
+		int64_t max(const int64_t *a, size_t n);
+		double max(const double *a, size_t n);
+		double mean(const int64_t *a, size_t n);
+		double mean(const double *a, size_t n);
+		bool dot(const int64_t *a, const int64_t *b, size_t n, int64_t &r);
+		double dot(const double *a, const double *b, size_t n);
+	}
+}
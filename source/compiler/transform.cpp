@@ -1,6 +1,7 @@
 #include "basic.h"
 #include "compiler/transform.h"
 #include "compiler/analysisbase.h"
+#include "runtime/typebase.h"
 //#include "runtime/objectdef.h"
 
 #include "temp-getelement.h"
@@ -96,6 +97,7 @@ namespace ICM
 				case list_:     return adjustNode(node, 1);
 				case p_:        return adjustNode(node, 1);
 				case call_:     return adjustNode(node, 1);
+				case struct_:   return adjustNode(node, 1);
 				case disp_:     return compileDisp(node, refelt);
 				case let_:
 				case set_:
@@ -104,6 +106,7 @@ namespace ICM
 				case dim_:
 				case restrict_: return compileRestrictDim(node, refelt);
 				case define_:   return compileDefine(node, refelt);
+				case defstruct_: return compileDefstruct(node, refelt);
 				default:        return error("Error with unkonwn Keyword.");
 				}
 			}
@@ -282,6 +285,15 @@ namespace ICM
 				else
 					return error("Syntax error in '" + ICM::to_string(key) + "'.");
 			}
+			// (defstruct I I...)
+			bool compileDefstruct(Node &node, Element &refelt) {
+				if (node.size() < 2)
+					return error("Syntax error in 'defstruct'.");
+				for (Element &e : rangei(node.begin() + 1, node.end()))
+					if (!e.isIdent())
+						return error("struct name and fields must be Identifier.");
+				return true;
+			}
 		};
 
 		/*class CompiletimeEvaluate : public AnalysisBase
@@ -308,19 +320,21 @@ namespace ICM
 		public:
 			IdentifierAnalysis(NodeTable &Table) : AnalysisBase(Table) {}
 
-			void start() {
+			// Return false if the form has an error, and should not be compiled.
+			bool start() {
 				if (PrintCompilingProcess)
 					println("IdentifierAnalysis");
 
-				setIdentSub(GetNode(1));
+				bool result = setIdentSub(GetNode(1));
 
 				if (PrintCompilingProcess) {
 					println("-->");
 					printTable();
 				}
+				return result;
 			}
 
-			void setIdentSub(Node &node) {
+			bool setIdentSub(Node &node) {
 				if (PrintCompilingProcess)
 					println(to_string(node));
 				// define
@@ -338,6 +352,12 @@ namespace ICM
 						println("Making Module...");
 						println(to_string(node[1]));
 					}
+					else if (node[0].getKeyword() == defstruct_) {
+						// The fields are not variables.
+						if (node.size() >= 2 && node[1].isIdent())
+							return defineStruct(node);
+						return true;
+					}
 				}
 				// other
 				bool change = false;
@@ -345,8 +365,10 @@ namespace ICM
 					Element &e = node[i];
 					if (e.isIdent())
 						setIdentifier(e);
-					else if (e.isRefer())
-						setIdentSub(GetRefer(e));
+					else if (e.isRefer()) {
+						if (!setIdentSub(GetRefer(e)))
+							return false;
+					}
 					else if (e.isKeyword() && i != 0)
 						setKeyword(e);
 					else if (isKey(e, disp_)) {
@@ -356,6 +378,14 @@ namespace ICM
 				}
 				if (change)
 					node.push_front(Element::Keyword(call_));
+				// struct
+				if (isKey(node[0], call_) || isKey(node[0], struct_)) {
+					if (node.size() >= 2 && (node[1].isIdentType(I_Struct) || node[1].isIdentType(I_Field)))
+						return setStruct(node);
+					else if (isKey(node[0], struct_))
+						return error("struct must be followed by a struct or a field.");
+				}
+				return true;
 			}
 
 		private:
@@ -387,14 +417,63 @@ namespace ICM
 					setIdent(element, I_StFunc, getGlobalFunctionIdentIndex("disp"));
 				}
 			}
+			// (defstruct S f...)
+			// Register S as I_Struct, and every S.f as I_Field with the offset of f.
+			bool defineStruct(Node &node) {
+				IdentSpaceIndex sid = getCurrentIdentSpaceIndex();
+				const string name = getIdentName(node[1]);
+				TypeBase::StructInfo info{ name, {} };
+				for (Element &e : rangei(node.begin() + 2, node.end())) {
+					const string &field = getIdentName(e);
+					if (std::find(info.fields.begin(), info.fields.end(), field) != info.fields.end())
+						return error("Duplicate field '" + field + "' in '" + name + "'.");
+					info.fields.push_back(field);
+				}
+				IdentIndex ii(sid);
+				if (isIdentDefined(node[1].getIndex(), ii))
+					return error("'" + name + "' is already defined.");
+				for (const string &field : info.fields)
+					if (isIdentDefined(GlobalIdentNameMap[name + "." + field], ii))
+						return error("'" + name + "." + field + "' is already defined.");
+
+				size_t index = TypeBase::GlobalStructTable.size();
+				ii.ident_index = insertFromIdentTable(sid, node[1].getIndex(), I_Struct);
+				getFromIdentTable(ii).StructIndex = index;
+				setIdent(node[1], I_Struct, ii);
+				for (size_t i : range(0, info.fields.size())) {
+					IdentIndex fi(sid, insertFromIdentTable(sid, GlobalIdentNameMap[name + "." + info.fields[i]], I_Field));
+					IdentTableUnit &itu = getFromIdentTable(fi);
+					itu.StructIndex = index;
+					itu.FieldIndex = (uint_t)i;
+				}
+				TypeBase::GlobalStructTable.push_back(std::move(info));
+				return true;
+			}
+			// (call/struct S E...) or (call/struct S.f E [V])
+			// --> (struct S E...) or (struct S.f E [V])
+			bool setStruct(Node &node) {
+				Element &ident = node[1];
+				const IdentTableUnit &itu = getFromIdentTable(getIdentID(ident));
+				const TypeBase::StructInfo &info = TypeBase::GlobalStructTable[itu.StructIndex];
+				size_t argc = node.size() - 2;
+				if (ident.isIdentType(I_Struct)) {
+					// Either all the fields, or none of them.
+					if (argc != 0 && argc != info.fields.size())
+						return error("'" + info.name + "' has " + std::to_string(info.fields.size()) + " fields.");
+				}
+				else if (argc != 1 && argc != 2)
+					return error("Syntax error in '" + getIdentName(ident) + "'.");
+				node[0] = Element::Keyword(struct_);
+				return true;
+			}
 			void setIdent(ASTBase::Element &elt, IdentType type, const IdentIndex &index) {
 				elt = ASTBase::Element::Identifier(type, ConvertIdentIndexToSizeT(index));
 			}
 		};
 
-		void transform(vector<AST::NodePtr> &Table) {
+		bool transform(vector<AST::NodePtr> &Table) {
 			PreliminaryCompile(Table).start();
-			IdentifierAnalysis(Table).start();
+			return IdentifierAnalysis(Table).start();
 		};
 	}
 }
@@ -40,6 +40,7 @@ namespace ICM
 			InstName(cpsm), InstName(cpse), InstName(cpla), InstName(cple), InstName(cpeq), InstName(cpne),
 			InstName(add), InstName(sub), InstName(mul), InstName(div), InstName(mod), InstName(rem),
 			InstName(dim), InstName(rest),
+			InstName(snew), InstName(sget), InstName(sset),
 		};
 #undef InstName
 	}
@@ -101,6 +102,8 @@ namespace ICM
 				case p_:        return createNodePrintIdent(node, refelt);
 				case dim_:      return createNodeDim(node, refelt);
 				case restrict_: return createNodeRestrict(node, refelt);
+				case struct_:   return createNodeStruct(node, refelt);
+				case defstruct_: return createNodeDefstruct(node, refelt);
 				case function_: return false;
 				case define_:   return false;
 				case defun_:    return false;
@@ -349,6 +352,35 @@ namespace ICM
 				InstList.push(new Insts::Assign(rest, ident_id, ConvertToInstElement(type)));
 				return true;
 			}
+			// (struct S args...), (struct S.f E), (struct S.f E V)
+			bool createNodeStruct(Node &node, Element &refelt) {
+				for (Element &e : rangei(node.begin() + 2, node.end()))
+					createReferNode(e);
+				const IdentTableUnit &itu = getFromIdentTable(getIdentID(node[1]));
+				if (node[1].isIdentType(I_Struct)) {
+					Insts::StructNew *inst = new Insts::StructNew(itu.StructIndex);
+					for (Element &e : rangei(node.begin() + 2, node.end()))
+						inst->Args.push_back(ConvertToInstElement(e));
+					InstList.push(inst);
+				}
+				else if (node.size() == 3) {
+					InstList.push(new Insts::StructField(sget, itu.StructIndex, itu.FieldIndex, ConvertToInstElement(node[2])));
+				}
+				else {
+					Insts::StructField *inst = new Insts::StructField(sset, itu.StructIndex, itu.FieldIndex, ConvertToInstElement(node[2]));
+					inst->Value = ConvertToInstElement(node[3]);
+					InstList.push(inst);
+				}
+				refelt.setRefer(CurrInstID());
+				return true;
+			}
+			// (defstruct S f...)
+			bool createNodeDefstruct(Node &, Element &refelt) {
+				// Done in compiling.
+				InstList.push(nop);
+				refelt.setRefer(CurrInstID());
+				return true;
+			}
 			// (list ...)
 			bool createNodeList(Node &node, Element &refelt) {
 				Insts::List *inst = new Insts::List();
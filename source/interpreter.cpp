@@ -2,7 +2,6 @@
 #include "interpreter.h"
 #include "runtime/objectdef.h"
 #include "temp-getelement2.h"
-#include <ctime>
 
 namespace ICM
 {
@@ -10,7 +9,7 @@ namespace ICM
 	{
 	public:
 		Interpreter(Instruction::InstructionList &InstList, const Compiler::ElementPool &EP)
-			: InstList(InstList), TempResult(InstList.size(), &Static.Null), EP(EP) {}
+			: InstList(InstList), TempResult(InstList.size(), &Static.Null), Slots(InstList.size(), nullptr), EP(EP) {}
 
 		Object* getObject(const Instruction::Element &element) {
 			if (element.isLiteral()) {
@@ -39,30 +38,57 @@ namespace ICM
 			}
 			return creater.data();
 		}
-		DataList createDispCallList(vector<Instruction::Element> &el, const FuncTableUnit* &ftup) {
-			list<Object*> datalist;
+		// Disperse is spread straight into the arguments,
+		// which are counted first, so that they are filled in one pass.
+		// Return the error, or null with the arguments in dl.
+		Object* createDispCallList(vector<Instruction::Element> &el, const FuncTableUnit* &ftup, DataList &dl) {
+			vector<Object*> ops;
+			ops.reserve(el.size());
+			size_t count = 0;
 			for (auto &e : el) {
 				Object *op = getObject(e);
 				if (op) {
-					if (op->type == T_Disperse) {
-						auto &ve = op->dat<T_Disperse>().getData();
-						datalist.insert(datalist.end(), ve.begin(), ve.end());
-					}
-					else {
-						datalist.push_back(op);
-					}
+					ops.push_back(op);
+					count += op->type == T_Disperse ? op->dat<T_Disperse>().size() : 1;
 				}
 			}
-			Object *fp = datalist.front();
-			datalist.pop_front();
-			if (fp->type != T_Function) {
-				println("'", fp->to_string(), "' is not Function.");
-				return DataList();
+			if (count == 0)
+				return createError("Nothing to call.").get();
+			Object *fp = nullptr;
+			lightlist_creater<Object*> creater(count - 1);
+			auto push = [&](Object *op) {
+				if (fp)
+					creater.push_back(op);
+				else
+					fp = op;
+			};
+			for (Object *op : ops) {
+				if (op->type == T_Disperse) {
+					for (Object *p : op->dat<T_Disperse>())
+						push(p);
+				}
+				else {
+					push(op);
+				}
 			}
+			if (fp->type != T_Function)
+				return createError("'" + fp->to_string() + "' is not Function.").get();
 			ftup = &fp->dat<T_Function>().getData();
-			return DataList(datalist.begin(), datalist.size());
+			dl = creater.data();
+			return nullptr;
+		}
+		// The result slot of a call is reused by the call on its next run,
+		// until its object may be kept, by a variable, a container or another result.
+		void release(size_t index, Object *op) {
+			if (Slots[index] == op)
+				Slots[index] = nullptr;
+		}
+		void release(const Instruction::Element &element) {
+			if (element.isRefer())
+				release(element.getRefer(), TempResult[element.getRefer()]);
 		}
-		Object* CheckCall(vector<Instruction::Element> &Data) {
+
+		Object* CheckCall(vector<Instruction::Element> &Data, size_t index) {
 			const FuncTableUnit *ftup;
 
 			Instruction::Element &front = Data.front();
@@ -86,14 +112,27 @@ namespace ICM
 				return nullptr;
 			}
 
-			DataList dl = createDispCallList(Data, ftup);
-			ObjectPtr op = checkCall(*ftup, dl);
+			DataList dl;
+			if (Object *error = createDispCallList(Data, ftup, dl))
+				return error;
+			ObjectPtr op;
+			if (checkCallL(*ftup, dl, Slots[index], op))
+				return Slots[index];
+			// The arguments may be kept by the call.
+			for (auto &e : Data)
+				release(e);
 			return op.get();
 		}
 
+		// The offset of a field is only valid for the struct it is resolved from.
+		Object* checkStruct(Object *op, size_t id) {
+			if (op->type == T_Struct && op->dat<T_Struct>().getID() == id)
+				return nullptr;
+			return createError("'" + op->to_string() + "' is not " + TypeBase::GlobalStructTable[id].name + ".").get();
+		}
+
 		Object* run() {
 			size_t ProgramCounter = 0;
-			std::srand(static_cast<unsigned>(std::time(0)));
 			while (true) {
 				using namespace Instruction;
 				auto &Inst = InstList[ProgramCounter];
@@ -101,8 +140,9 @@ namespace ICM
 				switch (Inst->inst()) {
 				case ccal: {
 					Insts::CheckCall &inst = static_cast<Insts::CheckCall&>(*Inst);
-					TempResult[ProgramCounter] = CheckCall(inst.Data);
+					TempResult[ProgramCounter] = CheckCall(inst.Data, ProgramCounter);
 					Result = TempResult[ProgramCounter];
+					ResultIndex = ProgramCounter;
 					break;
 				}
 						   /*case farg: {
@@ -160,6 +200,7 @@ namespace ICM
 						setDyVarbData(inst.VTU, createObjectFromLiteral(inst.Data, EP));
 					}
 					else if (inst.Data.isRefer()) {
+						release(inst.Data);
 						setDyVarbData(inst.VTU, TempResult[inst.Data.getRefer()]);
 					}
 					else if (inst.Data.isIdentType(I_DyVarb)) {
@@ -201,11 +242,14 @@ namespace ICM
 				}
 				case stor: {
 					Insts::Store &inst = static_cast<Insts::Store&>(*Inst);
+					release(inst.Data);
 					TempResult[ProgramCounter] = getObject(inst.Data); // TODO
 					Result = TempResult[ProgramCounter];
 					break;
 				}
 				case sing: {
+					// Result is from the last call, or is not in a slot.
+					release(ResultIndex, Result);
 					TempResult[ProgramCounter] = Result;
 					Result = TempResult[ProgramCounter];
 					break;
@@ -287,6 +331,36 @@ namespace ICM
 					}
 					break;
 				}
+				case snew: {
+					Insts::StructNew &inst = static_cast<Insts::StructNew&>(*Inst);
+					Objects::Struct *op = new Objects::Struct();
+					auto &st = op->dat<T_Struct>();
+					st = TypeBase::StructType(inst.Struct);
+					for (size_t i : range(0, inst.Args.size()))
+						st.set(i, getObject(inst.Args[i])->clone());
+					TempResult[ProgramCounter] = op;
+					Result = TempResult[ProgramCounter];
+					break;
+				}
+				case sget:
+				case sset: {
+					Insts::StructField &inst = static_cast<Insts::StructField&>(*Inst);
+					Object *op = getObject(inst.Data);
+					Object *error = checkStruct(op, inst.Struct);
+					if (error) {
+						TempResult[ProgramCounter] = error;
+					}
+					else if (Inst->inst() == sget) {
+						TempResult[ProgramCounter] = op->dat<T_Struct>().get(inst.Field);
+					}
+					else {
+						Object *value = getObject(inst.Value)->clone();
+						op->dat<T_Struct>().set(inst.Field, value);
+						TempResult[ProgramCounter] = value;
+					}
+					Result = TempResult[ProgramCounter];
+					break;
+				}
 				case end: {
 					return Result;
 				}
@@ -300,6 +374,8 @@ namespace ICM
 		Instruction::InstructionList& InstList;
 		Object* Result = &Static.Nil;
 		vector<Object*> TempResult;
+		vector<Object*> Slots;
+		size_t ResultIndex = 0;
 		const Compiler::ElementPool &EP;
 
 		struct {
@@ -92,7 +92,9 @@ vector<Instruction::InstructionList> Compile(const char *text, Compiler::Element
 			println("Output: ");
 			}*/
 			vector<AST::NodePtr> &Table = ast.getTable();
-			Compiler::transform(Table);
+			// The error is printed, and the form is skipped.
+			if (!Compiler::transform(Table))
+				continue;
 			auto instlist = Compiler::createInstruction(Table);
 			VeI.push_back(instlist);
 		}
@@ -137,6 +139,11 @@ int main(int argc, char *argv[])
 	// Test
 	test();
 
+	if (argc > 1 && string(argv[1]) == "--bench-dispatch") {
+		benchDispatch();
+		return 0;
+	}
+
 	string init_text;
 
 	// Load File
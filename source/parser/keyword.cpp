@@ -26,6 +26,8 @@ namespace ICM
 		{ "list",     Keyword::list_     },
 		{ "defun",    Keyword::defun_    },
 		{ "define",   Keyword::define_   },
+		{ "struct",   Keyword::struct_   },
+		{ "defstruct", Keyword::defstruct_ },
 		{ "call",     Keyword::call_     },
 		{ "do",       Keyword::do_       },
 		{ "restrict", Keyword::restrict_ },
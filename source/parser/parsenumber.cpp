@@ -1,19 +1,25 @@
 #include "basic.h"
 #include "parser/parsenumber.h"
+#include <cerrno>
+#include <cstring>
 
 // ** Integer (int64_t [default] / uint64_t):
-// * (+-) <0 [bodx]> [0-9,a-F,A-F]* (iu)
+// * (+-) <0 [bodx]> [0-9,a-F,A-F]* (iu) <8 16 32 64>
 // Examples :
 //   0xff = 0xffi = 255 = 255i -> int16
 //   0xffu = 255u -> uint8
+//   255u32 -> uint32
+//   -1i64 -> int64
+//   256u8 -> unknown (out of range)
 
-// ** Float (long double): 
+// ** Float (double, the bits are stored in value):
 // * (+-) <0 [bodx]> [0-9]* . <[0-9]*>
-// * (+-) [0-9]* [eE] (+-) [0-9]* <[+-] [0-9]*>
+// * (+-) [0-9]* <. [0-9]*> [eE] (+-) [0-9]* <[+-] [0-9]*>
 // Examples :
 //   0. = 0.0
 //   0x10. = 16.0
 //   0x10.5 = 16.3125
+//   1.5e3 = 1500
 //   10e1 = 100
 //   10e+1 = 100
 //   10e1+1 = 101
@@ -59,13 +65,11 @@ namespace ICM
 
 		static NumberType getLimitTypeFloat(uint64_t &value)
 		{
-			long double ld = (long double&)value;
-			double d = (double)ld;
-			float f = (float)ld;
+			double d = (double&)value;
+			float f = (float)d;
 
-			if (f == ld) return nt_float;
-			if (d == ld) return nt_double;
-			return nt_ldouble;
+			if (f == d) return nt_float;
+			return nt_double;
 		}
 
 
@@ -96,31 +100,54 @@ namespace ICM
 			long double f = (long double)std::stoull(front.c_str(), 0, format);
 			long double b = convertFloatPointBehind(behind.c_str(), format);
 
-			(long double&)value = (f + b) * (minus ? -1 : 1);
+			(double&)value = (double)((f + b) * (minus ? -1 : 1));
 			return getLimitTypeFloat(value);
 		}
 
+		// Decimal, rounded correctly by strtod.
 		static NumberType parseFloat(const string &str, uint64_t &value, bool minus)
 		{
-			long double v = std::stold(str.c_str());
+			char *end;
+			double v = std::strtod(str.c_str(), &end);
+			if (*end != '\0')
+				return nt_unknown;
 
-			(long double&)value = v * (minus ? -1 : 1);
+			(double&)value = minus ? -v : v;
 			return getLimitTypeFloat(value);
 		}
 
 		static NumberType parseUnsigned(const string &str, uint64_t &value, Format format)
 		{
-			(uint64_t&)value = std::stoull(str.c_str(), 0, format);
+			errno = 0;
+			(uint64_t&)value = std::strtoull(str.c_str(), 0, format);
+			if (errno == ERANGE)
+				return nt_unknown;
 			return getLimitTypeUInt(value);
 		}
 
 		static NumberType parseInteger(const string &str, uint64_t &value, bool minus, Format format)
 		{
 			string s = (minus ? "-" : "") + str;
-			(int64_t&)value = std::stoll(s.c_str(), 0, format);
+			errno = 0;
+			(int64_t&)value = std::strtoll(s.c_str(), 0, format);
+			if (errno == ERANGE)
+				return nt_unknown;
 			return getLimitTypeInt(value);
 		}
 
+		// The explicit width of the suffix, if the limit type fits in it.
+		static NumberType fixWidth(NumberType type, const char *width, bool sign)
+		{
+			static const NumberType signedTypes[] = { nt_int8, nt_int16, nt_int32, nt_int64 };
+			static const NumberType unsignedTypes[] = { nt_uint8, nt_uint16, nt_uint32, nt_uint64 };
+			const NumberType *types = sign ? signedTypes : unsignedTypes;
+			string w(width);
+			int i = w == "8" ? 0 : w == "16" ? 1 : w == "32" ? 2 : w == "64" ? 3 : -1;
+			if (type == nt_unknown || i < 0 || type > types[i])
+				return nt_unknown;
+			return types[i];
+		}
+
 		static bool checkBehindNumber(const char *ptr, int base = 10, const char **oend = nullptr)
 		{
 			while (judgeCharNumber(*ptr, base)) {
@@ -156,8 +183,11 @@ namespace ICM
 				case 'x': format = f_hex; ptr++; break;
 				case '.':
 					// Include : 0. -> 0.0
-					return checkBehindNumber(ptr + 1, format) ? parseFloat(ptr - 1, value, minus) : nt_unknown;
-				default: return nt_unknown;
+					return parseFloat(ptr - 1, value, minus);
+				default:
+					// Include : 0 0i 0u8
+					ptr--;
+					break;
 				}
 			}
 
@@ -171,15 +201,24 @@ namespace ICM
 			else {
 				if (*end == 'i' || *end == 'u') {
 					charptr cp(ptr, end);
+					bool sign = *end == 'i';
+					const char *width = end + 1;
 
-					if (*end == 'i') {
-						return parseInteger(cp.to_string(), value, minus, format);
+					NumberType type;
+					if (sign) {
+						type = parseInteger(cp.to_string(), value, minus, format);
 					}
 					else {
 						if (minus) return nt_unknown;
 
-						return parseUnsigned(cp.to_string(), value, format);
+						type = parseUnsigned(cp.to_string(), value, format);
 					}
+					return *width == '\0' ? type : fixWidth(type, width, sign);
+				}
+
+				if (*end == '.' && format == f_dec) {
+					// Include : 1.5 1.5e3
+					return parseFloat(ptr, value, minus);
 				}
 
 				if (*end == '.') {
@@ -212,8 +251,9 @@ namespace ICM
 					}
 					if (*end == '+' || *end == '-') {
 						charptr front(ptr, end);
-						long double result1;
-						parseFloat(front.to_string(), (uint64_t&)result1, minus);
+						double result1;
+						if (parseFloat(front.to_string(), (uint64_t&)result1, minus) == nt_unknown)
+							return nt_unknown;
 
 						minus = *end == '-';
 						ptr = end + 1;
@@ -226,7 +266,7 @@ namespace ICM
 						int64_t result2;
 						parseInteger(ptr, (uint64_t&)result2, minus, f_dec);
 
-						(long double&)value = result1 + (long double)result2;
+						(double&)value = result1 + (double)result2;
 						return getLimitTypeFloat(value);
 					}
 					if (*end != '\0')
@@ -238,5 +278,25 @@ namespace ICM
 
 			return nt_unknown;
 		}
+
+		bool hasIntegerSuffix(const char *ptr)
+		{
+			return std::strpbrk(ptr, "iu") != nullptr;
+		}
+
+		DefaultType getIntegerType(NumberType type)
+		{
+			switch (type) {
+			case nt_int8:   return T_Int8;
+			case nt_int16:  return T_Int16;
+			case nt_int32:  return T_Int32;
+			case nt_int64:  return T_Int64;
+			case nt_uint8:  return T_UInt8;
+			case nt_uint16: return T_UInt16;
+			case nt_uint32: return T_UInt32;
+			case nt_uint64: return T_UInt64;
+			default:        return T_Null;
+			}
+		}
 	}
 }
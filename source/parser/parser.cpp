@@ -2,6 +2,7 @@
 #include "parser/parser.h"
 #include "parser/keywordtable.h"
 #include "parser/literal.h"
+#include "parser/parsenumber.h"
 
 namespace ICM
 {
@@ -242,7 +243,9 @@ namespace ICM
 						break;
 					case 3:  // Match Long with function find
 						if (isdigit(c)) {
+							// A number like "-9/5", read it to the end.
 							firstfind = true;
+							mode = 2;
 						}
 						else {
 							if (firstfind) {
@@ -282,13 +285,56 @@ namespace ICM
 {
 	namespace Parser
 	{
+		// A literal with an integer suffix should fit its type.
+		bool checkIntegerLiteral(const string &str)
+		{
+			Compiler::Literal::Number num;
+			if (Rational::parse(str.c_str(), num) || !hasIntegerSuffix(str.c_str()))
+				return true;
+			uint64_t value;
+			return getIntegerType(parseNumber(str.c_str(), value)) != T_Null;
+		}
+
 		AST::Element createElementData(MatchType type, const string &str, Compiler::ElementPool &EP)
 		{
 			switch (type) {
 			case MT_Boolean:
 				return AST::Element::Literal(T_Boolean, EP.setBoolean(str == "T"));
 			case MT_Number:
-				return AST::Element::Literal(T_Number, EP.setNumber((int_t)(Common::Number::to_rational<long long>(str).num() / Common::Number::to_rational<long long>(str).den())));
+			{
+				Compiler::Literal::Number num;
+				if (!Rational::parse(str.c_str(), num)) {
+					uint64_t value;
+					NumberType type = parseNumber(str.c_str(), value);
+					if (hasIntegerSuffix(str.c_str())) {
+						switch (type) {
+						case nt_int8:   return AST::Element::Literal(T_Int8, EP.setInteger((int8_t)value));
+						case nt_int16:  return AST::Element::Literal(T_Int16, EP.setInteger((int16_t)value));
+						case nt_int32:  return AST::Element::Literal(T_Int32, EP.setInteger((int32_t)value));
+						case nt_int64:  return AST::Element::Literal(T_Int64, EP.setInteger((int64_t)value));
+						case nt_uint8:  return AST::Element::Literal(T_UInt8, EP.setInteger((uint8_t)value));
+						case nt_uint16: return AST::Element::Literal(T_UInt16, EP.setInteger((uint16_t)value));
+						case nt_uint32: return AST::Element::Literal(T_UInt32, EP.setInteger((uint32_t)value));
+						case nt_uint64: return AST::Element::Literal(T_UInt64, EP.setInteger((uint64_t)value));
+						default: break;
+						}
+					}
+					switch (type) {
+					case nt_float:
+					case nt_double:
+						return AST::Element::Literal(T_Double, EP.setDouble((double&)value));
+					case nt_int8:
+					case nt_int16:
+					case nt_int32:
+					case nt_int64:
+						num = Rational((int64_t)value);
+						break;
+					default:
+						num = Rational::NaN();
+					}
+				}
+				return AST::Element::Literal(T_Number, EP.setNumber(std::move(num)));
+			}
 			case MT_String:
 				return AST::Element::Literal(T_String, EP.setString(str.c_str(), str.size() + 1));
 			case MT_Keyword:
@@ -350,6 +396,10 @@ namespace ICM
 					break;
 				case MT_Identifier: case MT_Keyword:
 				case MT_Number: case MT_String: case MT_Boolean:
+					if (mr.getType() == MT_Number && !checkIntegerLiteral(mr.getString())) {
+						printf("Error integer literal '%s' in line(%d).\n", mr.getString().c_str(), match.getCurLineNum());
+						return false;
+					}
 					//if (firstMatchBraket) {
 					//	printf("Error '%s' is not function in line(%d).\n", mr.getString().c_str(), match.getCurLineNum());
 					//	return false;
@@ -0,0 +1,396 @@
+#include "basic.h"
+#include "runtime/bigint.h"
+#include "runtime/hashtable.h"
+#include "runtime/number.h"
+#include <cmath>
+
+namespace ICM
+{
+	//=======================================
+	// * Class BigInt
+	//=======================================
+	BigInt::BigInt(int64_t v) {
+		neg = v < 0;
+		uint64_t u = neg ? 0 - (uint64_t)v : (uint64_t)v;
+		while (u != 0) {
+			mag.push_back((Limb)u);
+			u >>= 32;
+		}
+	}
+
+	BigInt BigInt::parse(const char *begin, const char *end) {
+		BigInt r;
+		// Nine digits at a time.
+		const char *p = begin;
+		size_t first = (end - begin) % 9;
+		if (first == 0)
+			first = 9;
+		while (p < end) {
+			Limb chunk = 0;
+			for (const char *e = p + first; p < e; ++p)
+				chunk = chunk * 10 + (*p - '0');
+			uint64_t carry = chunk;
+			for (Limb &l : r.mag) {
+				carry += (uint64_t)l * 1000000000u;
+				l = (Limb)carry;
+				carry >>= 32;
+			}
+			if (carry != 0)
+				r.mag.push_back((Limb)carry);
+			first = 9;
+		}
+		r.trim();
+		return r;
+	}
+
+	void BigInt::trim() {
+		while (!mag.empty() && mag.back() == 0)
+			mag.pop_back();
+		if (mag.empty())
+			neg = false;
+	}
+
+	uint64_t BigInt::low64() const {
+		return (mag.size() > 0 ? mag[0] : 0) | (mag.size() > 1 ? (uint64_t)mag[1] << 32 : 0);
+	}
+	bool BigInt::fitsInt64() const {
+		if (mag.size() > 2)
+			return false;
+		return low64() <= (uint64_t)INT64_MAX + neg;
+	}
+	int64_t BigInt::toInt64() const {
+		uint64_t m = low64();
+		return (int64_t)(neg ? 0 - m : m);
+	}
+	double BigInt::to_double() const {
+		double r = 0;
+		size_t n = mag.size();
+		// The top three limbs hold more bits than a double.
+		for (size_t i = n; i > 0 && i + 3 > n; --i)
+			r = r * 4294967296.0 + mag[i - 1];
+		if (n > 3)
+			r = std::ldexp(r, 32 * (int)(n - 3));
+		return neg ? -r : r;
+	}
+	size_t BigInt::hash() const {
+		size_t h = Container::hash_mix(neg);
+		for (Limb l : mag)
+			h = Container::hash_combine(h, Container::hash_mix(l));
+		return h;
+	}
+
+	//=======================================
+	// * Magnitude
+	//=======================================
+	int BigInt::cmpMag(const Limbs &a, const Limbs &b) {
+		if (a.size() != b.size())
+			return a.size() < b.size() ? -1 : 1;
+		for (size_t i = a.size(); i > 0; --i)
+			if (a[i - 1] != b[i - 1])
+				return a[i - 1] < b[i - 1] ? -1 : 1;
+		return 0;
+	}
+	BigInt::Limbs BigInt::addMag(const Limbs &a, const Limbs &b) {
+		const Limbs &x = a.size() >= b.size() ? a : b;
+		const Limbs &y = a.size() >= b.size() ? b : a;
+		Limbs r(x.size() + 1);
+		uint64_t carry = 0;
+		for (size_t i = 0; i < x.size(); ++i) {
+			carry += (uint64_t)x[i] + (i < y.size() ? y[i] : 0);
+			r[i] = (Limb)carry;
+			carry >>= 32;
+		}
+		r[x.size()] = (Limb)carry;
+		while (!r.empty() && r.back() == 0)
+			r.pop_back();
+		return r;
+	}
+	BigInt::Limbs BigInt::subMag(const Limbs &a, const Limbs &b) {
+		Limbs r(a.size());
+		int64_t borrow = 0;
+		for (size_t i = 0; i < a.size(); ++i) {
+			int64_t t = (int64_t)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+			borrow = t < 0;
+			r[i] = (Limb)(t + (borrow << 32));
+		}
+		while (!r.empty() && r.back() == 0)
+			r.pop_back();
+		return r;
+	}
+	BigInt::Limbs BigInt::mulSchool(const Limb *a, size_t na, const Limb *b, size_t nb) {
+		Limbs r(na + nb);
+		for (size_t i = 0; i < na; ++i) {
+			uint64_t carry = 0;
+			for (size_t j = 0; j < nb; ++j) {
+				carry += (uint64_t)a[i] * b[j] + r[i + j];
+				r[i + j] = (Limb)carry;
+				carry >>= 32;
+			}
+			r[i + nb] = (Limb)carry;
+		}
+		while (!r.empty() && r.back() == 0)
+			r.pop_back();
+		return r;
+	}
+
+	// r += x << (32 * shift)
+	static void addShifted(vector<uint32_t> &r, const vector<uint32_t> &x, size_t shift) {
+		if (r.size() < x.size() + shift + 1)
+			r.resize(x.size() + shift + 1);
+		uint64_t carry = 0;
+		size_t i = 0;
+		for (; i < x.size(); ++i) {
+			carry += (uint64_t)r[i + shift] + x[i];
+			r[i + shift] = (uint32_t)carry;
+			carry >>= 32;
+		}
+		for (i += shift; carry != 0; ++i) {
+			if (i == r.size())
+				r.push_back(0);
+			carry += r[i];
+			r[i] = (uint32_t)carry;
+			carry >>= 32;
+		}
+		while (!r.empty() && r.back() == 0)
+			r.pop_back();
+	}
+
+	// Karatsuba above the threshold:
+	//   (a1 B + a0)(b1 B + b0) = z2 B^2 + ((a0 + a1)(b0 + b1) - z2 - z0) B + z0
+	BigInt::Limbs BigInt::mulMag(const Limb *a, size_t na, const Limb *b, size_t nb) {
+		if (na < nb) {
+			std::swap(a, b);
+			std::swap(na, nb);
+		}
+		if (nb < KaratsubaThreshold)
+			return mulSchool(a, na, b, nb);
+		size_t m = na / 2;
+		auto trimmed = [](const Limb *p, size_t n) {
+			while (n > 0 && p[n - 1] == 0)
+				--n;
+			return Limbs(p, p + n);
+		};
+		Limbs a0 = trimmed(a, m), a1 = trimmed(a + m, na - m);
+		if (nb <= m) {
+			// Unbalanced, split a only.
+			Limbs r = mulMag(a0.data(), a0.size(), b, nb);
+			addShifted(r, mulMag(a1.data(), a1.size(), b, nb), m);
+			return r;
+		}
+		Limbs b0 = trimmed(b, m), b1 = trimmed(b + m, nb - m);
+		Limbs z0 = mulMag(a0.data(), a0.size(), b0.data(), b0.size());
+		Limbs z2 = mulMag(a1.data(), a1.size(), b1.data(), b1.size());
+		Limbs sa = addMag(a0, a1), sb = addMag(b0, b1);
+		Limbs z1 = subMag(subMag(mulMag(sa.data(), sa.size(), sb.data(), sb.size()), z0), z2);
+		Limbs r = z0;
+		addShifted(r, z1, m);
+		addShifted(r, z2, 2 * m);
+		return r;
+	}
+
+	BigInt::Limb BigInt::divmodSmall(Limbs &a, Limb b) {
+		uint64_t rem = 0;
+		for (size_t i = a.size(); i > 0; --i) {
+			uint64_t cur = (rem << 32) | a[i - 1];
+			a[i - 1] = (Limb)(cur / b);
+			rem = cur % b;
+		}
+		while (!a.empty() && a.back() == 0)
+			a.pop_back();
+		return (Limb)rem;
+	}
+
+	// Knuth, TAOCP 4.3.1, Algorithm D
+	void BigInt::divmodMag(const Limbs &a, const Limbs &b, Limbs &q, Limbs &r) {
+		if (cmpMag(a, b) < 0) {
+			q.clear();
+			r = a;
+			return;
+		}
+		if (b.size() == 1) {
+			q = a;
+			Limb rem = divmodSmall(q, b[0]);
+			r.clear();
+			if (rem != 0)
+				r.push_back(rem);
+			return;
+		}
+		// Normalize, so that the top bit of the divisor is set.
+		int s = 0;
+		for (Limb top = b.back(); (top & 0x80000000u) == 0; top <<= 1)
+			++s;
+		auto shl = [s](const Limbs &x) {
+			Limbs y(x.size() + 1);
+			for (size_t i = x.size(); i > 0; --i) {
+				y[i] |= s ? x[i - 1] >> (32 - s) : 0;
+				y[i - 1] = x[i - 1] << s;
+			}
+			return y;
+		};
+		Limbs u = shl(a), v = shl(b);
+		v.resize(b.size());
+		size_t n = v.size(), m = a.size() - n;
+		q.assign(m + 1, 0);
+		const uint64_t base = (uint64_t)1 << 32;
+		for (size_t j = m + 1; j > 0; --j) {
+			size_t k = j - 1;
+			uint64_t num = ((uint64_t)u[k + n] << 32) | u[k + n - 1];
+			uint64_t qhat = num / v[n - 1];
+			uint64_t rhat = num % v[n - 1];
+			while (qhat >= base || qhat * v[n - 2] > ((rhat << 32) | u[k + n - 2])) {
+				--qhat;
+				rhat += v[n - 1];
+				if (rhat >= base)
+					break;
+			}
+			// Multiply and subtract.
+			int64_t borrow = 0;
+			uint64_t carry = 0;
+			for (size_t i = 0; i < n; ++i) {
+				carry += qhat * v[i];
+				int64_t t = (int64_t)u[i + k] - (int64_t)(carry & 0xffffffffu) - borrow;
+				carry >>= 32;
+				borrow = t < 0;
+				u[i + k] = (Limb)(t + (borrow << 32));
+			}
+			int64_t t = (int64_t)u[k + n] - (int64_t)carry - borrow;
+			borrow = t < 0;
+			u[k + n] = (Limb)(t + (borrow << 32));
+			// Add back, rarely needed.
+			if (borrow) {
+				--qhat;
+				uint64_t c = 0;
+				for (size_t i = 0; i < n; ++i) {
+					c += (uint64_t)u[i + k] + v[i];
+					u[i + k] = (Limb)c;
+					c >>= 32;
+				}
+				u[k + n] += (Limb)c;
+			}
+			q[k] = (Limb)qhat;
+		}
+		while (!q.empty() && q.back() == 0)
+			q.pop_back();
+		// Unnormalize the remainder.
+		r.assign(n, 0);
+		for (size_t i = 0; i < n; ++i)
+			r[i] = (u[i] >> s) | (s && i + 1 < u.size() ? u[i + 1] << (32 - s) : 0);
+		while (!r.empty() && r.back() == 0)
+			r.pop_back();
+	}
+
+	//=======================================
+	// * Operators
+	//=======================================
+	BigInt operator+(const BigInt &a, const BigInt &b) {
+		BigInt r;
+		if (a.neg == b.neg) {
+			r.mag = BigInt::addMag(a.mag, b.mag);
+			r.neg = a.neg;
+		}
+		else if (BigInt::cmpMag(a.mag, b.mag) >= 0) {
+			r.mag = BigInt::subMag(a.mag, b.mag);
+			r.neg = a.neg;
+		}
+		else {
+			r.mag = BigInt::subMag(b.mag, a.mag);
+			r.neg = b.neg;
+		}
+		r.trim();
+		return r;
+	}
+	BigInt operator-(const BigInt &a, const BigInt &b) {
+		return a + -b;
+	}
+	BigInt operator*(const BigInt &a, const BigInt &b) {
+		BigInt r;
+		if (a.isZero() || b.isZero())
+			return r;
+		r.mag = BigInt::mulMag(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+		r.neg = a.neg != b.neg;
+		r.trim();
+		return r;
+	}
+	void BigInt::divmod(const BigInt &a, const BigInt &b, BigInt &q, BigInt &r) {
+		assert(!b.isZero());
+		divmodMag(a.mag, b.mag, q.mag, r.mag);
+		q.neg = a.neg != b.neg;
+		r.neg = a.neg;
+		q.trim();
+		r.trim();
+	}
+	BigInt BigInt::floordiv(const BigInt &a, const BigInt &b) {
+		BigInt q, r;
+		divmod(a, b, q, r);
+		if (!r.isZero() && r.neg != b.neg)
+			q = q - BigInt(1);
+		return q;
+	}
+	int compare(const BigInt &a, const BigInt &b) {
+		if (a.neg != b.neg)
+			return a.neg ? -1 : 1;
+		int c = BigInt::cmpMag(a.mag, b.mag);
+		return a.neg ? -c : c;
+	}
+	BigInt gcd(BigInt a, BigInt b) {
+		a.neg = b.neg = false;
+		// Euclid on the big part, then the binary GCD once both fit in a word.
+		while (b.mag.size() > 2) {
+			BigInt r = a % b;
+			a = std::move(b);
+			b = std::move(r);
+		}
+		if (a.mag.size() > 2) {
+			if (b.isZero())
+				return a;
+			a = a % b;
+		}
+		uint64_t g = ICM::gcd(a.low64(), b.low64());
+		BigInt r;
+		for (; g != 0; g >>= 32)
+			r.mag.push_back((BigInt::Limb)g);
+		return r;
+	}
+
+	//=======================================
+	// * to_string
+	//---------------------------------------
+	//   Divide and conquer by 10^(9 * 2^k), so that
+	//   the conversion costs about as much as a division.
+	//=======================================
+	void BigInt::toStringRec(const BigInt &x, const vector<BigInt> &pows, int k, size_t width, string &out) {
+		if (k < 0 || x.mag.size() < 8) {
+			string s;
+			Limbs t = x.mag;
+			while (!t.empty()) {
+				Limb chunk = divmodSmall(t, 1000000000u);
+				for (int i = 0; i < 9 && (chunk != 0 || !t.empty()); ++i, chunk /= 10)
+					s.push_back(char('0' + chunk % 10));
+			}
+			if (width > s.size())
+				s.append(width - s.size(), '0');
+			std::reverse(s.begin(), s.end());
+			out.append(s);
+			return;
+		}
+		size_t w = (size_t)9 << k;
+		BigInt q, r;
+		divmod(x, pows[k], q, r);
+		if (width == 0 && q.isZero()) {
+			toStringRec(r, pows, k - 1, 0, out);
+			return;
+		}
+		toStringRec(q, pows, k - 1, width > w ? width - w : 0, out);
+		toStringRec(r, pows, k - 1, w, out);
+	}
+	string BigInt::to_string() const {
+		if (isZero())
+			return "0";
+		vector<BigInt> pows{ BigInt(1000000000) };
+		while (pows.back().mag.size() * 2 <= mag.size())
+			pows.push_back(pows.back() * pows.back());
+		string out = neg ? "-" : "";
+		toStringRec(abs(), pows, (int)pows.size() - 1, 0, out);
+		return out;
+	}
+}
@@ -1,9 +1,18 @@
 #include "basic.h"
 #include "runtime/deffunc.h"
 #include "parser/keyword.h"
+#include "parser/parsenumber.h"
 #include "runtime/objectdef.h"
 #include "runtime/caller.h"
+#include "runtime/native.h"
+#include "runtime/vecmath.h"
+#include "runtime/fixedint.h"
+#include "runtime/sortengine.h"
+#include "runtime/random.h"
 #include "config.h"
+#include <cmath>
+#include <chrono>
+#include <thread>
 
 namespace ICM
 {
@@ -12,52 +21,68 @@ namespace ICM
 
 	namespace DefFunc
 	{
-		using FuncResult = Runtime::FuncResult;
-		using FuncArgument = Runtime::FuncArgument;
-		using FuncCaller = Runtime::FuncCaller;
-
-		template <FuncCaller f>
-		ObjectPtr callfunc(FuncArgument list) {
-			Object *res = new Object;
-			f(res, list);
-			return ObjectPtr(res);
-		}
-
+		//=======================================
+		// * Native Functions
+		//---------------------------------------
+		//   Plain C++ functions, bound by BIND_NATIVE.
+		//=======================================
 		namespace CFunc
 		{
-			int_t iadd(int_t a, int_t b) { return a + b; }
-			int_t isub(int_t a, int_t b) { return a - b; }
-			int_t imul(int_t a, int_t b) { return a * b; }
-			int_t idiv(int_t a, int_t b) { return a / b; }
+			using Runtime::NativeResult;
 
-			using F = ICM::Function::FuncObject;
-			using FI = ICM::Function::FuncInitObject;
-			using S = ICM::Function::Signature;
-			using T = ICM::TypeObject;
+			// Integer operations fail on overflow, instead of promoting as Numbers do.
+			NativeResult<int_t> intResult(bool overflow, int64_t r) {
+				if (overflow || r < std::numeric_limits<int_t>::min() || r > std::numeric_limits<int_t>::max())
+					return NativeResult<int_t>::fail("Integer overflow.");
+				return (int_t)r;
+			}
+			NativeResult<int_t> iadd(int_t a, int_t b) { int64_t r; bool o = Checked::add(a, b, r); return intResult(o, r); }
+			NativeResult<int_t> isub(int_t a, int_t b) { int64_t r; bool o = Checked::sub(a, b, r); return intResult(o, r); }
+			NativeResult<int_t> imul(int_t a, int_t b) { int64_t r; bool o = Checked::mul(a, b, r); return intResult(o, r); }
+			NativeResult<int_t> idiv(int_t a, int_t b) {
+				if (b == 0)
+					return NativeResult<int_t>::fail("Division by zero.");
+				if (b == -1)
+					return isub(0, a);
+				return a / b;
+			}
+
+			double hypot(double a, double b) { return std::hypot(a, b); }
+			size_t string_length(const char *s) { return std::strlen(s); }
+			string string_repeat(const string &s, size_t n) {
+				string r;
+				r.reserve(s.size() * n);
+				while (n-- > 0)
+					r += s;
+				return r;
+			}
+			ListType reverse(const ListType &lt) {
+				vector<Object*> v(lt.getData().begin(), lt.getData().end());
+				std::reverse(v.begin(), v.end());
+				return ListType(v);
+			}
+			vector<int_t> iota(size_t n) {
+				vector<int_t> v(n);
+				for (size_t i : range(0, n))
+					v[i] = (int_t)i;
+				return v;
+			}
+			void sleep(uint_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
 
 			void addDefFuncs(FuncTable &DefFuncTable)
 			{
-				// TODO
-				using namespace ICM::DefFunc;
-				using Lst = std::initializer_list<F>;
-				using LST = std::initializer_list<FI*>;
+				using LST = std::initializer_list<ICM::Function::FuncInitObject*>;
 
-				DefFuncTable.insert("iadd", Lst{
-					F(callfunc<Runtime::Caller<::List<int_t, int_t>, int_t>::Type::call<iadd>>,
-					S({ T_Number, T_Number }, T_Number)),
-				});
-				DefFuncTable.insert("isub", Lst{
-					F(callfunc<Runtime::Caller<::List<int_t, int_t>, int_t>::Type::call<isub>>,
-					S({ T_Number, T_Number }, T_Number)),
-				});
-				DefFuncTable.insert("imul", Lst{
-					F(callfunc<Runtime::Caller<::List<int_t, int_t>, int_t>::Type::call<imul>>,
-					S({ T_Number, T_Number }, T_Number)),
-				});
-				DefFuncTable.insert("idiv", Lst{
-					F(callfunc<Runtime::Caller<::List<int_t, int_t>, int_t>::Type::call<idiv>>,
-					S({ T_Number, T_Number }, T_Number)),
-				});
+				DefFuncTable.insert("iadd", LST{ BIND_NATIVE("iadd", iadd) }); // (N N) -> N
+				DefFuncTable.insert("isub", LST{ BIND_NATIVE("isub", isub) }); // (N N) -> N
+				DefFuncTable.insert("imul", LST{ BIND_NATIVE("imul", imul) }); // (N N) -> N
+				DefFuncTable.insert("idiv", LST{ BIND_NATIVE("idiv", idiv) }); // (N N) -> N
+				DefFuncTable.insert("hypot", LST{ BIND_NATIVE("hypot", hypot) });                         // (D D) -> D
+				DefFuncTable.insert("string-length", LST{ BIND_NATIVE("string-length", string_length) }); // S -> N
+				DefFuncTable.insert("string-repeat", LST{ BIND_NATIVE("string-repeat", string_repeat) }); // (S N) -> S
+				DefFuncTable.insert("reverse", LST{ BIND_NATIVE("reverse", reverse) });                   // L -> L
+				DefFuncTable.insert("iota", LST{ BIND_NATIVE("iota", iota) });                            // N -> L
+				DefFuncTable.insert("sleep", LST{ BIND_NATIVE("sleep", sleep) });                         // N -> Nil
 			}
 		}
 
@@ -93,16 +118,25 @@ namespace ICM
 					return S({ t }, t, true); // T* -> T
 				}
 				ObjectPtr func(const DataList &list) const {
-					Object *tmp = list.front()->clone();
-					for (auto i : Range<size_t>(1, list.size()))
-						tmp->dat<_TU>() += list[i]->dat<_TU>();
-					return ObjectPtr(tmp);
+					return funcByL(list);
 				}
-				void funcL(Object &result, const LDataList &list) const {
-					Object *tmp = list.front()->clone();
+				bool funcL(Object* &result, const LDataList &list) const {
+					auto &r = resultSlot<(DefaultType)_TU>(result);
+					r = list.front()->dat<_TU>();
 					for (auto i : Range<size_t>(1, list.size()))
-						tmp->dat<_TU>() += list[i]->dat<_TU>();
-					result = *tmp;
+						r += list[i]->dat<_TU>();
+					return true;
+				}
+				bool funcV(Object **result, const Function::Columns &columns, size_t length) const {
+					Object *ops = newObjects<(DefaultType)_TU>(length);
+					for (size_t i : range(0, length)) {
+						auto &r = ops[i].dat<_TU>();
+						r = columns[0][i]->dat<_TU>();
+						for (auto j : Range<size_t>(1, columns.size()))
+							r += columns[j][i]->dat<_TU>();
+						result[i] = ops + i;
+					}
+					return true;
 				}
 			};
 			template <>
@@ -115,255 +149,2046 @@ namespace ICM
 				ObjectPtr func(const DataList &list) const {
 					return ObjectPtr(&Static.Zero);
 				}
-			};
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = 0;
+					return true;
+				}
+			};
+
+			struct NumCall : public FI
+			{
+			public:
+				using N = Types::Number;
+				using Func = void(*)(N&, const N&);
+				NumCall(Func fp) : fp(fp) {}
+
+			private:
+				S sign() const {
+					return S({ T_Number }, T_Number, true); // N* -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					N &r = resultSlot<T_Number>(result);
+					r = list.front()->dat<T_Number>();
+					for (auto i : Range<size_t>(1, list.size()))
+						fp(r, list[i]->dat<T_Number>());
+					return true;
+				}
+				bool funcV(Object **result, const Function::Columns &columns, size_t length) const {
+					Object *ops = newObjects<T_Number>(length);
+					for (size_t i : range(0, length)) {
+						N &r = ops[i].dat<T_Number>();
+						r = columns[0][i]->dat<T_Number>();
+						for (auto j : Range<size_t>(1, columns.size()))
+							fp(r, columns[j][i]->dat<T_Number>());
+						result[i] = ops + i;
+					}
+					return true;
+				}
+				Func fp;
+			};
+			struct Sub : public NumCall { Sub() : NumCall([](N &n1, const N &n2) { n1 -= n2; }) {} };
+			struct Mul : public NumCall { Mul() : NumCall([](N &n1, const N &n2) { n1 *= n2; }) {} };
+			struct Div : public NumCall { Div() : NumCall([](N &n1, const N &n2) { n1 /= n2; }) {} };
+
+			bool isReal(const Object *op) {
+				return op->type == T_Number || op->type == T_Double;
+			}
+			bool isNumeric(const Object *op) {
+				return isReal(op) || FixedInt::isFixedInt(op->type);
+			}
+			double toDouble(const Object *op) {
+				if (op->type == T_Double)
+					return op->dat<T_Double>();
+				if (op->type == T_Number)
+					return op->dat<T_Number>().to_double();
+				return FixedInt::toNumber(op->type, FixedInt::load(op)).to_double();
+			}
+			// Double infinities and NaN have no exact value, so they are ranked
+			// apart from the other numbers: -1 for -inf, 1 for inf, 2 for NaN,
+			// and 0 for the numbers toExact converts.
+			int rankOf(const Object *op) {
+				if (op->type != T_Double || std::isfinite(op->dat<T_Double>()))
+					return 0;
+				double d = op->dat<T_Double>();
+				return std::isnan(d) ? 2 : d < 0 ? -1 : 1;
+			}
+			// Every finite Double is a rational, so this is exact.
+			Rational toExact(const Object *op) {
+				if (op->type == T_Double)
+					return Rational::from_double(op->dat<T_Double>());
+				if (op->type == T_Number)
+					return op->dat<T_Number>();
+				return FixedInt::toNumber(op->type, FixedInt::load(op));
+			}
+			ObjectPtr numericError(const Object *op) {
+				return createError("'" + op->to_string() + "' is not numeric.");
+			}
+			ObjectPtr integerError(const Object *op) {
+				return createError("'" + op->to_string() + "' is not an integer.");
+			}
+
+			// Find the fixed-width type of the arguments, or T_Null for none.
+			// Return the error message, or an empty string.
+			string fixedType(const DataList &list, TypeUnit &type) {
+				type = T_Null;
+				for (Object *op : list) {
+					if (FixedInt::isFixedInt(op->type)) {
+						if (type != T_Null && type != op->type)
+							return "Mixed '" + string(TypeInfoTable.at(type).name) + "' and '" + string(TypeInfoTable.at(op->type).name) + "'.";
+						type = op->type;
+					}
+					else if (!isReal(op))
+						return "'" + op->to_string() + "' is not numeric.";
+				}
+				return string();
+			}
+			// Integral Numbers are converted, wrapping around.
+			bool loadFixed(TypeUnit type, const Object *op, uint64_t &v) {
+				if (op->type == type) {
+					v = FixedInt::load(op);
+					return true;
+				}
+				return op->type == T_Number && FixedInt::fromNumber(type, op->dat<T_Number>(), v);
+			}
+			void fixedCall(Object* &result, TypeUnit type, FixedInt::Operator fop, const DataList &list) {
+				uint64_t r, v;
+				if (!loadFixed(type, list[0], r)) {
+					result = integerError(list[0]).get();
+					return;
+				}
+				for (auto i : Range<size_t>(1, list.size())) {
+					if (!loadFixed(type, list[i], v)) {
+						result = integerError(list[i]).get();
+						return;
+					}
+					if (!FixedInt::calc(type, fop, r, v, r)) {
+						result = createError("Division by zero.").get();
+						return;
+					}
+				}
+				FixedInt::box(result, type, r);
+			}
+			ObjectPtr fixedCall(TypeUnit type, FixedInt::Operator fop, const DataList &list) {
+				Object *result = nullptr;
+				fixedCall(result, type, fop, list);
+				return ObjectPtr(result);
+			}
+
+			// Numbers, Doubles and fixed-width integers mixed.
+			// With a fixed-width integer, it wraps around in that type.
+			// Otherwise it goes on exactly until a Double is met,
+			// then the result is a Double.
+			struct MixedCall : public FI
+			{
+			public:
+				using N = Types::Number;
+				using NFunc = void(*)(N&, const N&);
+				using DFunc = void(*)(double&, double);
+				MixedCall(NFunc fn, DFunc fd, FixedInt::Operator fop) : fn(fn), fd(fd), fop(fop) {}
+
+			private:
+				S sign() const {
+					return S({ T_Vary }, T_Vary, true); // V* -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					TypeUnit type;
+					string err = fixedType(list, type);
+					if (!err.empty()) {
+						result = createError(err).get();
+						return true;
+					}
+					if (type != T_Null) {
+						fixedCall(result, type, fop, list);
+						return true;
+					}
+					size_t i = 1;
+					double d;
+					if (list[0]->type == T_Number) {
+						N n = list[0]->dat<T_Number>();
+						for (; i < list.size() && list[i]->type == T_Number; ++i)
+							fn(n, list[i]->dat<T_Number>());
+						if (i == list.size()) {
+							resultSlot<T_Number>(result) = std::move(n);
+							return true;
+						}
+						d = n.to_double();
+					}
+					else {
+						d = list[0]->dat<T_Double>();
+					}
+					for (; i < list.size(); ++i)
+						fd(d, toDouble(list[i]));
+					resultSlot<T_Double>(result) = d;
+					return true;
+				}
+				NFunc fn;
+				DFunc fd;
+				FixedInt::Operator fop;
+			};
+			struct MixedAdd : public MixedCall { MixedAdd() : MixedCall([](N &n1, const N &n2) { n1 += n2; }, [](double &d1, double d2) { d1 += d2; }, FixedInt::Add) {} };
+			struct MixedSub : public MixedCall { MixedSub() : MixedCall([](N &n1, const N &n2) { n1 -= n2; }, [](double &d1, double d2) { d1 -= d2; }, FixedInt::Sub) {} };
+			struct MixedMul : public MixedCall { MixedMul() : MixedCall([](N &n1, const N &n2) { n1 *= n2; }, [](double &d1, double d2) { d1 *= d2; }, FixedInt::Mul) {} };
+			struct MixedDiv : public MixedCall { MixedDiv() : MixedCall([](N &n1, const N &n2) { n1 /= n2; }, [](double &d1, double d2) { d1 /= d2; }, FixedInt::Div) {} };
+			struct MixedRem : public MixedCall { MixedRem() : MixedCall([](N &n1, const N &n2) { n1 = rem(n1, n2); }, [](double &d1, double d2) { d1 = std::fmod(d1, d2); }, FixedInt::Rem) {} };
+
+			struct Mod : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Number, T_Number }, T_Number); // (N N) -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = mod(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
+					return true;
+				}
+			};
+			struct Rem : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Number, T_Number }, T_Number); // (N N) -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = rem(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
+					return true;
+				}
+			};
+			struct Gcd : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Number, T_Number }, T_Number); // (N N) -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = gcd(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
+					return true;
+				}
+			};
+
+			struct Inc : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Number }, T_Number); // N -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = list[0]->dat<T_Number>() + 1;
+					return true;
+				}
+			};
+			struct Dec : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Number }, T_Number); // N -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = list[0]->dat<T_Number>() - 1;
+					return true;
+				}
+			};
+		}
+
+		//=======================================
+		// * Compare
+		//=======================================
+		namespace Comp
+		{
+			struct NumComp : public FI
+			{
+			public:
+				using N = Types::Number;
+				using Func = bool(*)(const N&, const N&);
+				NumComp(Func fp) : fp(fp) {}
+
+			private:
+				S sign() const {
+					return S({ T_Number, T_Number }, T_Boolean); // (N N) -> Bool
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Boolean>(result) = fp(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
+					return true;
+				}
+				// The results are the shared True and False, which are never changed.
+				bool funcV(Object **result, const Function::Columns &columns, size_t length) const {
+					for (size_t i : range(0, length)) {
+						bool r = fp(columns[0][i]->dat<T_Number>(), columns[1][i]->dat<T_Number>());
+						result[i] = r ? &Static.True : &Static.False;
+					}
+					return true;
+				}
+				Func fp;
+			};
+			struct NumSmallS : public NumComp { NumSmallS() : NumComp([](const N &n1, const N &n2) { return n1 < n2; }) {} };
+			struct NumSmallE : public NumComp { NumSmallE() : NumComp([](const N &n1, const N &n2) { return n1 <= n2; }) {} };
+			struct NumLargeL : public NumComp { NumLargeL() : NumComp([](const N &n1, const N &n2) { return n1 > n2; }) {} };
+			struct NumLargeE : public NumComp { NumLargeE() : NumComp([](const N &n1, const N &n2) { return n1 >= n2; }) {} };
+
+			bool equalNumeric(const Object *a, const Object *b) {
+				if (a->type == T_Double && b->type == T_Double)
+					return a->dat<T_Double>() == b->dat<T_Double>();
+				// Only a Double is infinite or NaN.
+				if (Calc::rankOf(a) != 0 || Calc::rankOf(b) != 0)
+					return false;
+				return Calc::toExact(a) == Calc::toExact(b);
+			}
+
+			// Mixed types are compared by their exact values.
+			struct MixedComp : public FI
+			{
+			public:
+				using N = Types::Number;
+				using NFunc = bool(*)(const N&, const N&);
+				using DFunc = bool(*)(double, double);
+				MixedComp(NFunc fn, DFunc fd) : fn(fn), fd(fd) {}
+
+			private:
+				S sign() const {
+					return S({ T_Vary, T_Vary }, T_Boolean); // (V V) -> Bool
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					for (Object *op : list) {
+						if (!Calc::isNumeric(op)) {
+							result = Calc::numericError(op).get();
+							return true;
+						}
+					}
+					Object *a = list[0], *b = list[1];
+					bool r;
+					int ra = Calc::rankOf(a), rb = Calc::rankOf(b);
+					if (a->type == T_Double && b->type == T_Double)
+						r = fd(a->dat<T_Double>(), b->dat<T_Double>());
+					else if (a->type == b->type && FixedInt::isFixedInt(a->type))
+						r = fn(FixedInt::compare(a->type, FixedInt::load(a), FixedInt::load(b)), 0);
+					else if (ra == 2 || rb == 2)
+						r = false;
+					else if (ra != 0 || rb != 0)
+						r = fn(ra - rb, 0); // An infinity against a finite number.
+					else
+						r = fn(Calc::toExact(a), Calc::toExact(b));
+					resultSlot<T_Boolean>(result) = r;
+					return true;
+				}
+				NFunc fn;
+				DFunc fd;
+			};
+			struct MixedSmallS : public MixedComp { MixedSmallS() : MixedComp([](const N &n1, const N &n2) { return n1 < n2; }, [](double d1, double d2) { return d1 < d2; }) {} };
+			struct MixedSmallE : public MixedComp { MixedSmallE() : MixedComp([](const N &n1, const N &n2) { return n1 <= n2; }, [](double d1, double d2) { return d1 <= d2; }) {} };
+			struct MixedLargeL : public MixedComp { MixedLargeL() : MixedComp([](const N &n1, const N &n2) { return n1 > n2; }, [](double d1, double d2) { return d1 > d2; }) {} };
+			struct MixedLargeE : public MixedComp { MixedLargeE() : MixedComp([](const N &n1, const N &n2) { return n1 >= n2; }, [](double d1, double d2) { return d1 >= d2; }) {} };
+
+			// The ids of < <= > >=, which sort orders by without calling them.
+			size_t SmallSID, SmallEID, LargeLID, LargeEID;
+
+			struct Equ : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Vary, T_Vary }, T_Boolean); // (Var Var) -> Boolean
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					auto &nn1 = list[0];
+					auto &nn2 = list[1];
+					if (nn1->type != nn2->type && Calc::isNumeric(nn1) && Calc::isNumeric(nn2))
+						resultSlot<T_Boolean>(result) = equalNumeric(nn1, nn2);
+					else
+						resultSlot<T_Boolean>(result) = nn1->equ(nn2);
+					return true;
+				}
+			};
+		}
+		//=======================================
+		// * Lists
+		//=======================================
+		namespace Lists
+		{
+			using L = List;
+
+			ObjectPtr list(const DataList &dl) {
+				return ObjectPtr(new List(ListType(dl)));
+			}
+			struct Make : public FI
+			{
+			public:
+				explicit Make(bool args) : args(args) {}
+
+			private:
+				S sign() const {
+					if (args)
+						return S({ T_Vary }, T_List, true); // Var* -> L
+					return S({}, T_List); // Void -> L
+				}
+				ObjectPtr func(const DataList &dl) const {
+					return list(dl);
+				}
+				// Each row as a list.
+				bool funcV(Object **result, const Function::Columns &columns, size_t length) const {
+					Object *ops = newObjects<T_List>(length);
+					for (size_t i : range(0, length)) {
+						ListType &l = ops[i].dat<T_List>();
+						l.reserve(columns.size());
+						for (auto column : columns)
+							l.push(column[i]);
+						result[i] = ops + i;
+					}
+					return true;
+				}
+				bool args;
+			};
+
+			// A view of the list, the elements are not copied.
+			ObjectPtr disp(const DataList &dl) {
+				return ObjectPtr(new Disperse(DisperseType(dl[0]->dat<T_List>())));
+			}
+
+			// The natural order of the elements: numbers by value, and strings by characters.
+			enum class Order { Number, Numeric, String, None };
+			template <typename Iter>
+			Order orderOf(Iter begin, Iter end) {
+				bool number = true, numeric = true, str = true;
+				for (Iter iter = begin; iter != end; ++iter) {
+					const Object *op = *iter;
+					number = number && op->type == T_Number;
+					numeric = numeric && Calc::isNumeric(op);
+					str = str && op->type == T_String;
+				}
+				return number ? Order::Number : numeric ? Order::Numeric : str ? Order::String : Order::None;
+			}
+			bool lessNumber(const Object *a, const Object *b) {
+				return a->dat<T_Number>() < b->dat<T_Number>();
+			}
+			// -inf is the least, and inf then NaN are the greatest.
+			bool lessNumeric(const Object *a, const Object *b) {
+				if (a->type == T_Double && b->type == T_Double) {
+					double x = a->dat<T_Double>(), y = b->dat<T_Double>();
+					if (!std::isnan(x) && !std::isnan(y))
+						return x < y;
+				}
+				else if (a->type == b->type && FixedInt::isFixedInt(a->type))
+					return FixedInt::compare(a->type, FixedInt::load(a), FixedInt::load(b)) < 0;
+				int ra = Calc::rankOf(a), rb = Calc::rankOf(b);
+				if (ra != 0 || rb != 0)
+					return ra < rb;
+				return Calc::toExact(a) < Calc::toExact(b);
+			}
+			bool lessString(const Object *a, const Object *b) {
+				return std::strcmp(a->dat<T_String>().c_str(), b->dat<T_String>().c_str()) < 0;
+			}
+
+			// Integers, or Doubles other than NaN, are sorted by their keys.
+			bool sortKeys(Object **data, size_t n, Order order, bool reverse) {
+				if (n < SortEngine::RadixMin || (order != Order::Number && order != Order::Numeric))
+					return false;
+				vector<SortEngine::Keyed> keyed(n);
+				for (size_t i : range(0, n)) {
+					Object *op = data[i];
+					uint64_t key;
+					if (order == Order::Number) {
+						const Rational &r = op->dat<T_Number>();
+						if (!r.isInteger())
+							return false;
+						key = SortEngine::key(r.num());
+					}
+					else {
+						if (op->type != T_Double || std::isnan(op->dat<T_Double>()))
+							return false;
+						key = SortEngine::key(op->dat<T_Double>());
+					}
+					keyed[i] = SortEngine::Keyed{ reverse ? ~key : key, op };
+				}
+				SortEngine::sortKeyed(keyed.data(), n);
+				for (size_t i : range(0, n))
+					data[i] = (Object*)keyed[i].item;
+				return true;
+			}
+			template <typename Less>
+			void sortWith(Object **data, size_t n, bool reverse, bool stable, Less less) {
+				if (reverse)
+					SortEngine::sort(data, n, [&](const Object *a, const Object *b) { return less(b, a); }, stable);
+				else
+					SortEngine::sort(data, n, less, stable);
+			}
+			// Sort in the natural order, or in reverse, without calling a function.
+			// Return false if the elements are neither all numeric nor all strings.
+			bool sortNatural(Object **data, size_t n, Order order, bool reverse, bool stable) {
+				if (sortKeys(data, n, order, reverse))
+					return true;
+				switch (order) {
+				case Order::Number:
+					sortWith(data, n, reverse, stable, [](const Object *a, const Object *b) { return lessNumber(a, b); });
+					return true;
+				case Order::Numeric:
+					sortWith(data, n, reverse, stable, [](const Object *a, const Object *b) { return lessNumeric(a, b); });
+					return true;
+				case Order::String:
+					sortWith(data, n, reverse, stable, [](const Object *a, const Object *b) { return lessString(a, b); });
+					return true;
+				default:
+					return false;
+				}
+			}
+
+			// Compare by calling a function that returns a Boolean.
+			// The overload for the types of the first call is kept for the arguments
+			// of the same types, and its results are written into one slot.
+			// After an error, every comparison is false.
+			class CallLess
+			{
+			public:
+				explicit CallLess(const FuncTableUnit &ftu) : ftu(ftu) {}
+
+				bool operator()(Object *a, Object *b) {
+					if (err)
+						return false;
+					DataList args{ a, b };
+					if (!rf && a->type == b->type) {
+						size_t id = getCallID(ftu, args);
+						if (id != ftu.size()) {
+							rf = &ftu[id];
+							type = a->type;
+						}
+					}
+					ObjectPtr op;
+					bool cached = rf && a->type == type && b->type == type;
+					bool inSlot = cached ? rf->callL(slot, args) : checkCallL(ftu, args, slot, op);
+					if (!inSlot && cached)
+						op = rf->call(args);
+					Object *r = inSlot ? slot : op.get();
+					if (r->type != T_Boolean) {
+						err = r->type == T_Error ? r : createError("'" + r->to_string() + "' from '" + ftu.getName() + "' is not a Boolean.").get();
+						return false;
+					}
+					return r->dat<T_Boolean>();
+				}
+				Object* error() const {
+					return err;
+				}
+
+			private:
+				const FuncTableUnit &ftu;
+				const Function::FuncObject *rf = nullptr;
+				TypeUnit type = T_Null;
+				Object *slot = nullptr, *err = nullptr;
+			};
+
+			ObjectPtr sortList(Object *list, bool stable) {
+				ListType &lt = *list->get<T_List>();
+				if (!sortNatural(lt.begin(), lt.size(), orderOf(lt.begin(), lt.end()), false, stable))
+					return createError("Elements of the list cannot be compared.");
+				return ObjectPtr(list);
+			}
+			ObjectPtr sortList(Object *list, Object *func, bool stable) {
+				ListType &lt = *list->get<T_List>();
+				const FunctionType &ft = func->dat<T_Function>();
+
+				// Numbers are compared here. As sorts need a strict order,
+				// <= and >= sort as < and >, which only differ on equal values.
+				Order order = orderOf(lt.begin(), lt.end());
+				if (order == Order::Number || order == Order::Numeric) {
+					if (ft.index == Comp::SmallSID || ft.index == Comp::SmallEID) {
+						sortNatural(lt.begin(), lt.size(), order, false, stable);
+						return ObjectPtr(list);
+					}
+					if (ft.index == Comp::LargeLID || ft.index == Comp::LargeEID) {
+						sortNatural(lt.begin(), lt.size(), order, true, stable);
+						return ObjectPtr(list);
+					}
+				}
+
+				CallLess less(ft.getData());
+				auto call = [&](Object *a, Object *b) { return less(a, b); };
+				if (stable)
+					std::stable_sort(lt.begin(), lt.end(), call);
+				else
+					std::sort(lt.begin(), lt.end(), call);
+				return ObjectPtr(less.error() ? less.error() : list);
+			}
+
+			ObjectPtr sort(const DataList &dl) {
+				return sortList(dl[0], false);
+			}
+			ObjectPtr sort_f(const DataList &dl) {
+				return sortList(dl[0], dl[1], false);
+			}
+			ObjectPtr sort_stable(const DataList &dl) {
+				return sortList(dl[0], true);
+			}
+			ObjectPtr sort_stable_f(const DataList &dl) {
+				return sortList(dl[0], dl[1], true);
+			}
+
+			//=======================================
+			// * Sorted Lists
+			//---------------------------------------
+			//   The lists are in the order of sort with the same
+			//   function, or in the natural order without one.
+			//=======================================
+			class Ordering
+			{
+			public:
+				explicit Ordering(Object *func) {
+					if (!func)
+						return;
+					size_t index = func->dat<T_Function>().index;
+					numbers = index == Comp::SmallSID || index == Comp::SmallEID || index == Comp::LargeLID || index == Comp::LargeEID;
+					reverse = index == Comp::LargeLID || index == Comp::LargeEID;
+					call.reset(new CallLess(func->dat<T_Function>().getData()));
+				}
+
+				bool operator()(Object *a, Object *b) {
+					if (err)
+						return false;
+					if (call && !(numbers && Calc::isNumeric(a) && Calc::isNumeric(b))) {
+						bool r = (*call)(a, b);
+						err = call->error();
+						return r;
+					}
+					if (reverse)
+						std::swap(a, b);
+					if (a->type == T_Number && b->type == T_Number)
+						return lessNumber(a, b);
+					if (Calc::isNumeric(a) && Calc::isNumeric(b))
+						return lessNumeric(a, b);
+					if (a->type == T_String && b->type == T_String)
+						return lessString(a, b);
+					err = createError("'" + a->to_string() + "' and '" + b->to_string() + "' cannot be compared.").get();
+					return false;
+				}
+				Object* error() const {
+					return err;
+				}
+
+			private:
+				bool numbers = false, reverse = false;
+				std::unique_ptr<CallLess> call;
+				Object *err = nullptr;
+			};
+
+			// The index of the first element not less than the value.
+			ObjectPtr lower_bound(const DataList &dl) {
+				const auto &lt = dl[0]->dat<T_List>().getData();
+				Ordering less(dl.size() > 2 ? dl[2] : nullptr);
+				auto iter = std::lower_bound(lt.begin(), lt.end(), dl[1], [&](Object *a, Object *b) { return less(a, b); });
+				if (less.error())
+					return ObjectPtr(less.error());
+				return ObjectPtr(new Number(NumberType(iter - lt.begin())));
+			}
+			// The index of the first element greater than the value.
+			ObjectPtr upper_bound(const DataList &dl) {
+				const auto &lt = dl[0]->dat<T_List>().getData();
+				Ordering less(dl.size() > 2 ? dl[2] : nullptr);
+				auto iter = std::upper_bound(lt.begin(), lt.end(), dl[1], [&](Object *a, Object *b) { return less(a, b); });
+				if (less.error())
+					return ObjectPtr(less.error());
+				return ObjectPtr(new Number(NumberType(iter - lt.begin())));
+			}
+			// The index of an element equal to the value, or nil.
+			ObjectPtr bsearch(const DataList &dl) {
+				const auto &lt = dl[0]->dat<T_List>().getData();
+				Ordering less(dl.size() > 2 ? dl[2] : nullptr);
+				auto iter = std::lower_bound(lt.begin(), lt.end(), dl[1], [&](Object *a, Object *b) { return less(a, b); });
+				bool found = iter != lt.end() && !less(dl[1], *iter);
+				if (less.error())
+					return ObjectPtr(less.error());
+				return ObjectPtr(found ? new Number(NumberType(iter - lt.begin())) : &Static.Nil);
+			}
+
+			// A new sorted list from the two, in linear time.
+			template <typename Merge>
+			ObjectPtr mergeWith(const DataList &dl, Merge merge) {
+				const auto &a = dl[0]->dat<T_List>().getData();
+				const auto &b = dl[1]->dat<T_List>().getData();
+				Ordering less(dl.size() > 2 ? dl[2] : nullptr);
+				vector<Object*> r;
+				r.reserve(a.size() + b.size());
+				merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r), [&](Object *x, Object *y) { return less(x, y); });
+				if (less.error())
+					return ObjectPtr(less.error());
+				return ObjectPtr(new List(ListType(r)));
+			}
+			// Equal elements of the first come first.
+			ObjectPtr merge(const DataList &dl) {
+				return mergeWith(dl, [](auto... args) { return std::merge(args...); });
+			}
+			// The elements in either, an element equal in both is taken from the first.
+			ObjectPtr set_union(const DataList &dl) {
+				return mergeWith(dl, [](auto... args) { return std::set_union(args...); });
+			}
+			ObjectPtr set_intersection(const DataList &dl) {
+				return mergeWith(dl, [](auto... args) { return std::set_intersection(args...); });
+			}
+			// The elements of the first that are not in the second.
+			ObjectPtr set_difference(const DataList &dl) {
+				return mergeWith(dl, [](auto... args) { return std::set_difference(args...); });
+			}
+
+			class Mul : public FI
+			{
+				S sign() const {
+					return S({ T_List, T_Number }, T_List); // (L N) -> L
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					const ListType &l = list[0]->dat<T_List>();
+					size_t n = (size_t)list[1]->dat<T_Number>()/*->getNum()*/;
+					ListType &r = resultSlot<T_List>(result);
+					r.clear();
+					r.reserve(l.size() * n);
+					for (size_t i : Range<size_t>(0, n))
+						r.push(l.getData());
+					return true;
+				}
+			};
+
+			class Reserve : public FI
+			{
+				S sign() const {
+					return S({ T_List, T_Number }, T_List); // (L N) -> L
+				}
+				ObjectPtr func(const DataList &list) const {
+					ListType &l = *list[0]->get<T_List>();
+					l.reserve((size_t)list[1]->dat<T_Number>());
+					return list[0];
+				}
+			};
+
+			class Capacity : public FI
+			{
+				S sign() const {
+					return S({ T_List }, T_Number); // L -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = NumberType(list[0]->dat<T_List>().capacity());
+					return true;
+				}
+			};
+
+			class Push : public FI
+			{
+				S sign() const {
+					return S({ T_List, T_Vary }, T_List); // (L V) -> L
+				}
+				ObjectPtr func(const DataList &list) const {
+					ListType &l = *list[0]->get<T_List>();
+					l.push(list[1]);
+					return list[0];
+				}
+			};
+
+			// The elements as an array, copied into buf if they are not contiguous.
+			Object* const* column(const ListType &lt, vector<Object*> &) {
+				return lt.getData().data();
+			}
+			Object* const* column(const SliceType &st, vector<Object*> &buf) {
+				buf.resize(st.size());
+				for (size_t i : range(0, st.size()))
+					buf[i] = st.at(i);
+				return buf.data();
+			}
+			// Every column has elements of a single type,
+			// so that the overload for the first row suits all of them.
+			bool isUniform(const Function::Columns &columns, size_t length) {
+				for (auto column : columns)
+					for (size_t i : range(1, length))
+						if (column[i]->type != column[0]->type)
+							return false;
+				return true;
+			}
+
+			// Call the function on each of the length rows of the columns.
+			// The overload is found once, and called on all the rows at a time if it can be.
+			void callColumns(const FuncTableUnit &ftu, const Function::Columns &columns, size_t length, Object **result) {
+				size_t count = columns.size();
+				DataList row(count);
+				auto setRow = [&](size_t i) {
+					for (auto j : range(0, count))
+						row[j] = columns[j][i];
+				};
+
+				size_t id = ftu.size();
+				if (length != 0 && isUniform(columns, length)) {
+					setRow(0);
+					id = getCallID(ftu, row);
+				}
+				if (id != ftu.size()) {
+					const auto &rf = ftu[id];
+					if (!rf.callV(result, columns, length)) {
+						for (size_t i : range(0, length)) {
+							setRow(i);
+							result[i] = rf.call(row).get();
+						}
+					}
+				}
+				else {
+					for (size_t i : range(0, length)) {
+						setRow(i);
+						result[i] = checkCall(ftu, row).get();
+					}
+				}
+			}
+
+			template <TypeUnit _TU>
+			struct Foreach : public FI
+			{
+			private:
+				S sign() const {
+					DefaultType t = (DefaultType)_TU;
+					return S({ T(T_Function,S({ T_Vary },T_Vary,true)), t }, T_List, true); // (F(V*->V) L*) -> L
+				}
+				ObjectPtr func(const DataList &list) const {
+					const FuncTableUnit &ftu = list[0]->get<T_Function>()->getData();
+					size_t count = list.size() - 1;
+					size_t length = list[1]->dat<_TU>().size();
+					for (auto i : range(2, list.size()))
+						length = std::min(length, list[i]->dat<_TU>().size());
+
+					vector<vector<Object*>> bufs(count);
+					Function::Columns columns(count);
+					for (auto i : range(0, count))
+						columns[i] = column(list[i + 1]->dat<_TU>(), bufs[i]);
+					vector<Object*> dls(length);
+					callColumns(ftu, columns, length, dls.data());
+					return ObjectPtr(new List(ListType(dls)));
+				}
+			};
+
+			// Each key is found once, and the elements are ordered by their keys.
+			// Elements with the same key keep their order.
+			ObjectPtr sort_by(const DataList &dl) {
+				ListType &lt = *dl[0]->get<T_List>();
+				const FuncTableUnit &ftu = dl[1]->get<T_Function>()->getData();
+				size_t length = lt.size();
+				vector<Object*> keys(length);
+				callColumns(ftu, Function::Columns{ lt.getData().data() }, length, keys.data());
+				for (Object *key : keys)
+					if (key->type == T_Error)
+						return ObjectPtr(key);
+				Order order = orderOf(keys.begin(), keys.end());
+				if (order == Order::None)
+					return createError("Keys from '" + ftu.getName() + "' cannot be compared.");
+
+				vector<std::pair<Object*, Object*>> pairs(length);
+				for (size_t i : range(0, length))
+					pairs[i] = std::make_pair(keys[i], lt.begin()[i]);
+				auto less = order == Order::Number ? lessNumber : order == Order::String ? lessString : lessNumeric;
+				SortEngine::sort(pairs.data(), length, [&](const std::pair<Object*, Object*> &a, const std::pair<Object*, Object*> &b) {
+					return less(a.first, b.first);
+				}, true);
+				for (size_t i : range(0, length))
+					lt.begin()[i] = pairs[i].second;
+				return ObjectPtr(dl[0]);
+			}
+
+			struct Size : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_List }, T_Number); // L -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Number>(result) = NumberType(list[0]->dat<T_List>().size());
+					return true;
+				}
+			};
+
+			struct Swap : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_List, T_Number, T_Number }, T_List); // (L N N) -> L
+				}
+				ObjectPtr func(const DataList &list) const {
+					ListType &l = *list[0]->get<T_List>();
+					size_t i1 = (size_t)list[1]->dat<T_Number>()/*->getNum()*/;
+					size_t i2 = (size_t)list[2]->dat<T_Number>()/*->getNum()*/;
+					std::iter_swap(l.begin() + i1, l.begin() + i2);
+					return list[0];
+				}
+			};
+
+			struct At : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_List, T_Number }, T_Vary); // (L N) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					const TypeBase::ListType &lt = list[0]->dat<T_List>();
+					size_t id = (size_t)list[1]->dat<T_Number>()/*->getNum()*/;
+					const ObjectPtr &op = lt.getData()[id];
+					return op;
+				}
+			};
+
+			struct Set : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_List, T_Number, T_Vary }, T_Vary); // (L N V) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					ListType &l = *list[0]->get<T_List>();
+					*(l.begin() + (size_t)list[1]->dat<T_Number>()/*->getNum()*/) = list[2];
+					return list[2];
+				}
+			};
+		}
+
+		//=======================================
+		// * Arrays
+		//=======================================
+		namespace Arrays
+		{
+			ObjectPtr typeError(TypeUnit type) {
+				return createError("Array of '" + string(TypeInfoTable.at(type).name) + "' is unsupported.");
+			}
+			ObjectPtr elemError(Object *op) {
+				if (op->type == T_Double)
+					return createError("Array element '" + op->to_string() + "' is out of range.");
+				return createError("Array element should be numeric, but got '" + op->to_string() + "'.");
+			}
+			ObjectPtr indexError(size_t id, size_t size) {
+				return createError("Index " + std::to_string(id) + " out of range [0, " + std::to_string(size) + ").");
+			}
+
+			ObjectPtr fromList(TypeUnit type, const ListType &lt) {
+				if (!ArrayType::isElemType(type))
+					return typeError(type);
+				ArrayType at(type);
+				at.resize(lt.size());
+				for (size_t i : range(0, lt.size()))
+					if (!at.set(i, lt.getData()[i]))
+						return elemError(lt.getData()[i]);
+				return ObjectPtr(new Objects::Array(at));
+			}
+
+			ObjectPtr create(const DataList &dl) {
+				TypeUnit type = dl[0]->get<T_Type>()->get();
+				if (!ArrayType::isElemType(type))
+					return typeError(type);
+				return ObjectPtr(new Objects::Array(ArrayType(type)));
+			}
+			ObjectPtr create_l(const DataList &dl) {
+				return fromList(dl[0]->get<T_Type>()->get(), dl[1]->dat<T_List>());
+			}
+			ObjectPtr list_to_array(const DataList &dl) {
+				return fromList(dl[1]->get<T_Type>()->get(), dl[0]->dat<T_List>());
+			}
+			ObjectPtr array_to_list(const DataList &dl) {
+				const ArrayType &at = dl[0]->dat<T_Array>();
+				ListType lt;
+				lt.reserve(at.size());
+				for (size_t i : range(0, at.size()))
+					lt.push(at.get(i));
+				return ObjectPtr(new List(lt));
+			}
+			ObjectPtr sort(const DataList &dl) {
+				dl[0]->get<T_Array>()->sort();
+				return ObjectPtr(dl[0]);
+			}
+
+			struct Size : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Array }, T_Number); // A -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					size_t s = list[0]->get<T_Array>()->size();
+					return ObjectPtr(new Number(NumberType(s)));
+				}
+			};
+
+			struct Push : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Array, T_Vary }, T_Array); // (A V) -> A
+				}
+				ObjectPtr func(const DataList &list) const {
+					if (!list[0]->get<T_Array>()->push(list[1]))
+						return elemError(list[1]);
+					return list[0];
+				}
+			};
+
+			struct At : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Array, T_Number }, T_Vary); // (A N) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					const ArrayType &at = list[0]->dat<T_Array>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= at.size())
+						return indexError(id, at.size());
+					return ObjectPtr(at.get(id));
+				}
+			};
+
+			struct Set : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Array, T_Number, T_Vary }, T_Vary); // (A N V) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					ArrayType &at = *list[0]->get<T_Array>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= at.size())
+						return indexError(id, at.size());
+					if (!at.set(id, list[2]))
+						return elemError(list[2]);
+					return list[2];
+				}
+			};
+		}
+
+		//=======================================
+		// * PVectors
+		//=======================================
+		namespace PVectors
+		{
+			// Values are copied in, so that they stay the same in every version.
+			ObjectPtr create(const DataList &dl) {
+				PVectorType pv;
+				for (Object *op : dl)
+					pv = pv.conj(op->clone());
+				return ObjectPtr(new PVector(pv));
+			}
+			ObjectPtr list_to_pvec(const DataList &dl) {
+				ListType lt;
+				for (Object *op : dl[0]->dat<T_List>().getData())
+					lt.push(op->clone());
+				return ObjectPtr(new PVector(PVectorType(lt)));
+			}
+			ObjectPtr pvec_to_list(const DataList &dl) {
+				return ObjectPtr(new List(dl[0]->dat<T_PVector>().to_list()));
+			}
+
+			struct Size : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_PVector }, T_Number); // P -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					size_t s = list[0]->dat<T_PVector>().size();
+					return ObjectPtr(new Number(NumberType(s)));
+				}
+			};
+
+			struct At : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_PVector, T_Number }, T_Vary); // (P N) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					const PVectorType &pv = list[0]->dat<T_PVector>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= pv.size())
+						return Arrays::indexError(id, pv.size());
+					// The element is shared by the versions, so that a copy is given out.
+					return ObjectPtr(pv.at(id)->clone());
+				}
+			};
+
+			struct Assoc : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_PVector, T_Number, T_Vary }, T_PVector); // (P N V) -> P
+				}
+				ObjectPtr func(const DataList &list) const {
+					const PVectorType &pv = list[0]->dat<T_PVector>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					// Setting the one past the end appends.
+					if (id > pv.size())
+						return Arrays::indexError(id, pv.size() + 1);
+					return ObjectPtr(new PVector(pv.assoc(id, list[2]->clone())));
+				}
+			};
+
+			struct Conj : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_PVector, T_Vary }, T_PVector, true); // (P V*) -> P
+				}
+				ObjectPtr func(const DataList &list) const {
+					PVectorType pv = list[0]->dat<T_PVector>();
+					for (size_t i : range(1, list.size()))
+						pv = pv.conj(list[i]->clone());
+					return ObjectPtr(new PVector(pv));
+				}
+			};
+		}
+
+		//=======================================
+		// * Slices
+		//=======================================
+		namespace Slices
+		{
+			// Resolve (begin [end [step]]) in dl[1..] on a sequence of the size,
+			// as Python does: negative indices count from the end,
+			// and the ones out of range are clamped.
+			// Return the error message, or an empty string.
+			string resolve(size_t size, const DataList &dl, size_t &begin, size_t &length, ptrdiff_t &step) {
+				step = dl.size() > 3 ? (ptrdiff_t)dl[3]->dat<T_Number>() : 1;
+				if (step == 0)
+					return "Slice step cannot be zero.";
+				ptrdiff_t n = (ptrdiff_t)size;
+				ptrdiff_t lower = step > 0 ? 0 : -1;
+				ptrdiff_t upper = step > 0 ? n : n - 1;
+				auto clamp = [&](ptrdiff_t i) {
+					if (i < 0)
+						i += n;
+					return i < lower ? lower : i > upper ? upper : i;
+				};
+				ptrdiff_t b = clamp((ptrdiff_t)dl[1]->dat<T_Number>());
+				ptrdiff_t e = dl.size() > 2 ? clamp((ptrdiff_t)dl[2]->dat<T_Number>()) : upper;
+				if (step > 0)
+					length = e > b ? (size_t)((e - b + step - 1) / step) : 0;
+				else
+					length = b > e ? (size_t)((b - e - step - 1) / -step) : 0;
+				begin = length == 0 ? 0 : (size_t)b;
+				return "";
+			}
+
+			ObjectPtr slice(const DataList &dl) {
+				ListType &lt = *dl[0]->get<T_List>();
+				size_t begin, length;
+				ptrdiff_t step;
+				string msg = resolve(lt.size(), dl, begin, length, step);
+				if (!msg.empty())
+					return createError(msg);
+				return ObjectPtr(new Slice(SliceType(lt, begin, length, step)));
+			}
+			// A slice of a slice views the same list.
+			ObjectPtr slice_s(const DataList &dl) {
+				const SliceType &st = dl[0]->dat<T_Slice>();
+				size_t begin, length;
+				ptrdiff_t step;
+				string msg = resolve(st.size(), dl, begin, length, step);
+				if (!msg.empty())
+					return createError(msg);
+				return ObjectPtr(new Slice(st.slice(begin, length, step)));
+			}
+			ObjectPtr slice_to_list(const DataList &dl) {
+				return ObjectPtr(new List(dl[0]->dat<T_Slice>().to_list()));
+			}
+
+			// Sort a copy, the list under the slice is unchanged.
+			ObjectPtr sort(const DataList &dl) {
+				return Lists::sort(DataList{ new List(dl[0]->dat<T_Slice>().to_list()) });
+			}
+			ObjectPtr sort_f(const DataList &dl) {
+				return Lists::sort_f(DataList{ new List(dl[0]->dat<T_Slice>().to_list()), dl[1] });
+			}
+			ObjectPtr sort_by(const DataList &dl) {
+				return Lists::sort_by(DataList{ new List(dl[0]->dat<T_Slice>().to_list()), dl[1] });
+			}
+			ObjectPtr sort_stable(const DataList &dl) {
+				return Lists::sort_stable(DataList{ new List(dl[0]->dat<T_Slice>().to_list()) });
+			}
+			ObjectPtr sort_stable_f(const DataList &dl) {
+				return Lists::sort_stable_f(DataList{ new List(dl[0]->dat<T_Slice>().to_list()), dl[1] });
+			}
+
+			struct Size : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Slice }, T_Number); // S -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					size_t s = list[0]->dat<T_Slice>().size();
+					return ObjectPtr(new Number(NumberType(s)));
+				}
+			};
+
+			struct At : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Slice, T_Number }, T_Vary); // (S N) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					const SliceType &st = list[0]->dat<T_Slice>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= st.size())
+						return Arrays::indexError(id, st.size());
+					return ObjectPtr(st.at(id));
+				}
+			};
+
+			// Write through to the list.
+			struct Set : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Slice, T_Number, T_Vary }, T_Vary); // (S N V) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					SliceType &st = *list[0]->get<T_Slice>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= st.size())
+						return Arrays::indexError(id, st.size());
+					st.set(id, list[2]);
+					return list[2];
+				}
+			};
+		}
+
+		//=======================================
+		// * Deques
+		//=======================================
+		namespace Deques
+		{
+			ObjectPtr emptyError() {
+				return createError("Deque is empty.");
+			}
+
+			// Values are copied in, as the list instruction does.
+			ObjectPtr create(const DataList &dl) {
+				DequeType dt;
+				for (Object *op : dl)
+					dt.push_back(op->clone());
+				return ObjectPtr(new Deque(dt));
+			}
+			ObjectPtr list_to_deque(const DataList &dl) {
+				return ObjectPtr(new Deque(DequeType(dl[0]->dat<T_List>())));
+			}
+			ObjectPtr deque_to_list(const DataList &dl) {
+				return ObjectPtr(new List(dl[0]->dat<T_Deque>().to_list()));
+			}
+
+			ObjectPtr push_front(const DataList &dl) {
+				dl[0]->get<T_Deque>()->push_front(dl[1]->clone());
+				return ObjectPtr(dl[0]);
+			}
+			ObjectPtr push_back(const DataList &dl) {
+				dl[0]->get<T_Deque>()->push_back(dl[1]->clone());
+				return ObjectPtr(dl[0]);
+			}
+			ObjectPtr pop_front(const DataList &dl) {
+				DequeType &dt = *dl[0]->get<T_Deque>();
+				if (dt.empty())
+					return emptyError();
+				return ObjectPtr(dt.pop_front());
+			}
+			ObjectPtr pop_back(const DataList &dl) {
+				DequeType &dt = *dl[0]->get<T_Deque>();
+				if (dt.empty())
+					return emptyError();
+				return ObjectPtr(dt.pop_back());
+			}
+			ObjectPtr front(const DataList &dl) {
+				const DequeType &dt = dl[0]->dat<T_Deque>();
+				if (dt.empty())
+					return emptyError();
+				return ObjectPtr(dt.front());
+			}
+			ObjectPtr back(const DataList &dl) {
+				const DequeType &dt = dl[0]->dat<T_Deque>();
+				if (dt.empty())
+					return emptyError();
+				return ObjectPtr(dt.back());
+			}
+
+			struct Size : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Deque }, T_Number); // Q -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					size_t s = list[0]->dat<T_Deque>().size();
+					return ObjectPtr(new Number(NumberType(s)));
+				}
+			};
+
+			struct At : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Deque, T_Number }, T_Vary); // (Q N) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					const DequeType &dt = list[0]->dat<T_Deque>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= dt.size())
+						return Arrays::indexError(id, dt.size());
+					return ObjectPtr(dt.at(id));
+				}
+			};
+
+			struct Set : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Deque, T_Number, T_Vary }, T_Vary); // (Q N V) -> V
+				}
+				ObjectPtr func(const DataList &list) const {
+					DequeType &dt = *list[0]->get<T_Deque>();
+					size_t id = (size_t)list[1]->dat<T_Number>();
+					if (id >= dt.size())
+						return Arrays::indexError(id, dt.size());
+					dt.set(id, list[2]);
+					return list[2];
+				}
+			};
+
+			struct Push : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_Deque, T_Vary }, T_Deque); // (Q V) -> Q
+				}
+				ObjectPtr func(const DataList &list) const {
+					return push_back(list);
+				}
+			};
+		}
+
+		//=======================================
+		// * PQueues
+		//=======================================
+		namespace PQueues
+		{
+			ObjectPtr emptyError() {
+				return createError("Priority queue is empty.");
+			}
+
+			ObjectPtr create(const DataList &dl) {
+				return ObjectPtr(new PQueue());
+			}
+			ObjectPtr push(const DataList &dl) {
+				const Object *priority = dl[1];
+				if (!Calc::isNumeric(priority))
+					return Calc::numericError(priority);
+				// In the order of sort.
+				int rank = Calc::rankOf(priority);
+				NumberType key = rank == 0 ? Calc::toExact(priority) : NumberType(0);
+				if (rank == 2 || key.isNaN())
+					return createError("Priority cannot be NaN.");
+				dl[0]->get<T_PQueue>()->push(rank, key, priority->clone(), dl[2]->clone());
+				return ObjectPtr(dl[0]);
+			}
+			ObjectPtr pop(const DataList &dl) {
+				PQueueType &pq = *dl[0]->get<T_PQueue>();
+				if (pq.empty())
+					return emptyError();
+				return ObjectPtr(pq.pop());
+			}
+			ObjectPtr top(const DataList &dl) {
+				const PQueueType &pq = dl[0]->dat<T_PQueue>();
+				if (pq.empty())
+					return emptyError();
+				return ObjectPtr(pq.top());
+			}
+			ObjectPtr priority(const DataList &dl) {
+				const PQueueType &pq = dl[0]->dat<T_PQueue>();
+				if (pq.empty())
+					return emptyError();
+				return ObjectPtr(pq.topPriority());
+			}
+			ObjectPtr pqueue_to_list(const DataList &dl) {
+				return ObjectPtr(new List(dl[0]->dat<T_PQueue>().to_list()));
+			}
+
+			struct Size : public FI
+			{
+			private:
+				S sign() const {
+					return S({ T_PQueue }, T_Number); // PQ -> N
+				}
+				ObjectPtr func(const DataList &list) const {
+					size_t s = list[0]->dat<T_PQueue>().size();
+					return ObjectPtr(new Number(NumberType(s)));
+				}
+			};
+		}
+
+		//=======================================
+		// * Vectors
+		//=======================================
+		namespace Vectors
+		{
+			// An unboxed operand. Packed arrays of Int64/Double are used in place.
+			struct Operand
+			{
+				// Int < Ratio < Float, operands are promoted to the larger kind.
+				enum Kind { Int, Ratio, Float };
+
+				const int64_t *iptr = nullptr;
+				const Rational *rptr = nullptr;
+				const double *dptr = nullptr;
+				vector<int64_t> ibuf;
+				vector<Rational> rbuf;
+				vector<double> dbuf;
+				Kind kind = Int;
+				size_t size = 1;
+				bool scalar = true;
+				bool isarray = false;
+
+				void promote(Kind k) {
+					if (k <= kind)
+						return;
+					if (k == Ratio) {
+						rbuf.assign(iptr, iptr + size);
+						rptr = rbuf.data();
+					}
+					else {
+						dbuf.resize(size);
+						for (size_t i : range(0, size))
+							dbuf[i] = kind == Int ? (double)iptr[i] : rptr[i].to_double();
+						dptr = dbuf.data();
+					}
+					kind = k;
+				}
+				size_t step() const {
+					return scalar ? 0 : 1;
+				}
+			};
+
+			Operand::Kind kindOf(Object *op) {
+				if (op->type == T_Double)
+					return Operand::Float;
+				if (op->type == T_Number)
+					return op->dat<T_Number>().isInteger() ? Operand::Int : Operand::Ratio;
+				// UInt64 out of the int64 range.
+				return Calc::toExact(op).isInteger() ? Operand::Int : Operand::Ratio;
+			}
+
+			// Unbox the elements of a list or a slice.
+			template <typename _Seq>
+			bool loadElems(const _Seq &seq, Operand &od) {
+				size_t size = seq.size();
+				od.size = size;
+				for (size_t i : range(0, size)) {
+					if (!Calc::isNumeric(seq.at(i)))
+						return false;
+					od.kind = std::max(od.kind, kindOf(seq.at(i)));
+				}
+				switch (od.kind) {
+				case Operand::Int:
+					od.ibuf.resize(size);
+					for (size_t i : range(0, size)) {
+						Object *e = seq.at(i);
+						od.ibuf[i] = e->type == T_Number ? e->dat<T_Number>().num() : (int64_t)FixedInt::load(e);
+					}
+					od.iptr = od.ibuf.data();
+					break;
+				case Operand::Ratio:
+					od.rbuf.resize(size);
+					for (size_t i : range(0, size))
+						od.rbuf[i] = Calc::toExact(seq.at(i));
+					od.rptr = od.rbuf.data();
+					break;
+				case Operand::Float:
+					od.dbuf.resize(size);
+					for (size_t i : range(0, size))
+						od.dbuf[i] = Calc::toDouble(seq.at(i));
+					od.dptr = od.dbuf.data();
+					break;
+				}
+				return true;
+			}
+
+			bool load(Object *op, Operand &od) {
+				switch (op->type) {
+				case T_Number:
+				case T_Double:
+					od.scalar = true;
+					return loadElems(vector<Object*>{ op }, od);
+				case T_List:
+					od.scalar = false;
+					return loadElems(op->dat<T_List>(), od);
+				case T_Slice:
+					od.scalar = false;
+					return loadElems(op->dat<T_Slice>(), od);
+				case T_Array: {
+					const ArrayType &at = op->dat<T_Array>();
+					od.scalar = false;
+					od.isarray = true;
+					od.size = at.size();
+					switch (at.getElemType()) {
+					case T_Int64:
+						od.iptr = at.data<int64_t>();
+						break;
+					case T_Double:
+						od.dptr = at.data<double>();
+						od.kind = Operand::Float;
+						break;
+					default:
+						if (ArrayType::isFloatType(at.getElemType())) {
+							od.dbuf.resize(at.size());
+							at.visit([&](const auto *p) { std::copy(p, p + at.size(), od.dbuf.begin()); });
+							od.dptr = od.dbuf.data();
+							od.kind = Operand::Float;
+						}
+						else {
+							od.ibuf.resize(at.size());
+							at.visit([&](const auto *p) { std::copy(p, p + at.size(), od.ibuf.begin()); });
+							od.iptr = od.ibuf.data();
+						}
+					}
+					return true;
+				}
+				default:
+					return false;
+				}
+			}
+
+			// Unbox both operands, promote them to a common kind, and check the sizes.
+			// Return the error message, or an empty string.
+			string prepare(const DataList &dl, Operand &a, Operand &b, size_t &n) {
+				if (!load(dl[0], a))
+					return "'" + dl[0]->to_string() + "' is not numeric.";
+				if (!load(dl[1], b))
+					return "'" + dl[1]->to_string() + "' is not numeric.";
+				if (!a.scalar && !b.scalar && a.size != b.size)
+					return "Size mismatch (" + std::to_string(a.size) + " and " + std::to_string(b.size) + ").";
+				Operand::Kind kind = std::max(a.kind, b.kind);
+				// Arrays have no rational elements.
+				if (kind == Operand::Ratio && (a.isarray || b.isarray))
+					kind = Operand::Float;
+				a.promote(kind);
+				b.promote(kind);
+				n = a.scalar ? b.size : a.size;
+				return string();
+			}
+
+			Object* box(int64_t v) {
+				return new Number(NumberType(v));
+			}
+			Object* box(const Rational &v) {
+				return new Number(v);
+			}
+			Object* box(double v) {
+				return new Objects::Double(v);
+			}
+			Object* box(uint8_t v) {
+				return new Number(NumberType(v));
+			}
+
+			template <typename T>
+			ObjectPtr boxList(const vector<T> &r, bool scalar) {
+				if (scalar)
+					return ObjectPtr(box(r[0]));
+				ListType lt;
+				lt.reserve(r.size());
+				for (const T &v : r)
+					lt.push(box(v));
+				return ObjectPtr(new List(lt));
+			}
+			template <typename T>
+			ObjectPtr boxArray(const vector<T> &r, TypeUnit elemtype) {
+				ArrayType at(elemtype);
+				at.resize(r.size());
+				std::copy(r.begin(), r.end(), at.data<T>());
+				return ObjectPtr(new Objects::Array(at));
+			}
+			template <typename T>
+			ObjectPtr result(const vector<T> &r, const Operand &a, const Operand &b, TypeUnit elemtype) {
+				if (!(a.scalar && b.scalar) && (a.isarray || b.isarray))
+					return boxArray(r, elemtype);
+				return boxList(r, a.scalar && b.scalar);
+			}
+
+			ObjectPtr overflowError() {
+				return createError("Number overflow or division by zero.");
+			}
+
+			template <VecMath::Operator Op>
+			Rational ratioCalc(const Rational &a, const Rational &b) {
+				switch (Op) {
+				case VecMath::Add: return a + b;
+				case VecMath::Sub: return a - b;
+				case VecMath::Mul: return a * b;
+				case VecMath::Div: return a / b;
+				case VecMath::Min: return b < a ? b : a;
+				case VecMath::Max: return a < b ? b : a;
+				}
+				return Rational::NaN();
+			}
+			template <VecMath::Compare Op>
+			bool ratioCompare(const Rational &a, const Rational &b) {
+				switch (Op) {
+				case VecMath::Less:         return a < b;
+				case VecMath::LessEqual:    return a <= b;
+				case VecMath::Greater:      return a > b;
+				case VecMath::GreaterEqual: return a >= b;
+				case VecMath::Equal:        return a == b;
+				case VecMath::NotEqual:     return a != b;
+				}
+				return false;
+			}
+
+			template <VecMath::Operator Op>
+			ObjectPtr calc(const DataList &dl) {
+				Operand a, b;
+				size_t n;
+				string err = prepare(dl, a, b, n);
+				if (!err.empty())
+					return createError(err);
+				switch (a.kind) {
+				case Operand::Int: {
+					vector<int64_t> r(n);
+					if (VecMath::calc(Op, a.iptr, a.step(), b.iptr, b.step(), r.data(), n))
+						return result(r, a, b, T_Int64);
+					if (a.isarray || b.isarray)
+						return overflowError();
+					// Numbers are promoted to big integers.
+					a.promote(Operand::Ratio);
+					b.promote(Operand::Ratio);
+				}
+				// fall through
+				case Operand::Ratio: {
+					vector<Rational> r(n);
+					for (size_t i : range(0, n))
+						if ((r[i] = ratioCalc<Op>(a.rptr[i * a.step()], b.rptr[i * b.step()])).isNaN())
+							return overflowError();
+					return boxList(r, a.scalar && b.scalar);
+				}
+				default: {
+					vector<double> r(n);
+					VecMath::calc(Op, a.dptr, a.step(), b.dptr, b.step(), r.data(), n);
+					return result(r, a, b, T_Double);
+				}
+				}
+			}
+
+			// Return a mask of 0 and 1.
+			template <VecMath::Compare Op>
+			ObjectPtr compare(const DataList &dl) {
+				Operand a, b;
+				size_t n;
+				string err = prepare(dl, a, b, n);
+				if (!err.empty())
+					return createError(err);
+				vector<uint8_t> r(n);
+				switch (a.kind) {
+				case Operand::Int:
+					VecMath::compare(Op, a.iptr, a.step(), b.iptr, b.step(), r.data(), n);
+					break;
+				case Operand::Ratio:
+					for (size_t i : range(0, n))
+						r[i] = ratioCompare<Op>(a.rptr[i * a.step()], b.rptr[i * b.step()]);
+					break;
+				default:
+					VecMath::compare(Op, a.dptr, a.step(), b.dptr, b.step(), r.data(), n);
+				}
+				return result(r, a, b, T_UInt8);
+			}
+
+			//=======================================
+			// * Reductions
+			//=======================================
+			ObjectPtr intResult(int64_t r) {
+				return ObjectPtr(box(r));
+			}
+			ObjectPtr ratioResult(const Rational &r) {
+				if (r.isNaN())
+					return overflowError();
+				return ObjectPtr(box(r));
+			}
+			ObjectPtr floatResult(double r) {
+				return ObjectPtr(box(r));
+			}
+
+			template <VecMath::Operator Op>
+			Rational ratioReduce(const Rational *a, size_t n, Rational init) {
+				for (size_t i : range(0, n)) {
+					init = ratioCalc<Op>(init, a[i]);
+					if (init.isNaN())
+						break;
+				}
+				return init;
+			}
 
-			struct NumCall : public FI
-			{
-			public:
-				using N = Types::Number;
-				using Func = std::function<void(N&, const N&)>;
-				NumCall(const Func &fp) : fp(fp) {}
+			// F is called with the loaded operand, if it is numeric and not empty.
+			template <typename F>
+			ObjectPtr reduce(Object *op, bool allowEmpty, F f) {
+				Operand a;
+				if (!load(op, a))
+					return createError("'" + op->to_string() + "' is not numeric.");
+				if (a.size == 0 && !allowEmpty)
+					return createError("Reduction of empty sequence.");
+				return f(a);
+			}
 
-			private:
-				S sign() const {
-					return S({ T_Number }, T_Number, true); // N* -> N
+			ObjectPtr sum(const DataList &dl) {
+				return reduce(dl[0], true, [](Operand &a) {
+					if (a.kind == Operand::Float)
+						return floatResult(VecMath::sum(a.dptr, a.size));
+					if (a.kind == Operand::Ratio)
+						return ratioResult(ratioReduce<VecMath::Add>(a.rptr, a.size, 0));
+					int64_t r;
+					if (VecMath::sum(a.iptr, a.size, r))
+						return intResult(r);
+					a.promote(Operand::Ratio);
+					return ratioResult(ratioReduce<VecMath::Add>(a.rptr, a.size, 0));
+				});
+			}
+			// Numbers are summed exactly anyway, so only doubles differ from sum.
+			ObjectPtr sum_exact(const DataList &dl) {
+				return reduce(dl[0], true, [&](Operand &a) {
+					if (a.kind == Operand::Float)
+						return floatResult(VecMath::sum_exact(a.dptr, a.size));
+					return sum(dl);
+				});
+			}
+			ObjectPtr product(const DataList &dl) {
+				return reduce(dl[0], true, [](Operand &a) {
+					if (a.kind == Operand::Float)
+						return floatResult(VecMath::product(a.dptr, a.size));
+					if (a.kind == Operand::Ratio)
+						return ratioResult(ratioReduce<VecMath::Mul>(a.rptr, a.size, 1));
+					int64_t r;
+					if (VecMath::product(a.iptr, a.size, r))
+						return intResult(r);
+					a.promote(Operand::Ratio);
+					return ratioResult(ratioReduce<VecMath::Mul>(a.rptr, a.size, 1));
+				});
+			}
+			ObjectPtr min(const DataList &dl) {
+				return reduce(dl[0], false, [](Operand &a) {
+					if (a.kind == Operand::Float)
+						return floatResult(VecMath::min(a.dptr, a.size));
+					if (a.kind == Operand::Ratio)
+						return ratioResult(ratioReduce<VecMath::Min>(a.rptr, a.size, a.rptr[0]));
+					return intResult(VecMath::min(a.iptr, a.size));
+				});
+			}
+			ObjectPtr max(const DataList &dl) {
+				return reduce(dl[0], false, [](Operand &a) {
+					if (a.kind == Operand::Float)
+						return floatResult(VecMath::max(a.dptr, a.size));
+					if (a.kind == Operand::Ratio)
+						return ratioResult(ratioReduce<VecMath::Max>(a.rptr, a.size, a.rptr[0]));
+					return intResult(VecMath::max(a.iptr, a.size));
+				});
+			}
+			ObjectPtr mean(const DataList &dl) {
+				return reduce(dl[0], false, [](Operand &a) {
+					if (a.kind == Operand::Float)
+						return floatResult(VecMath::mean(a.dptr, a.size));
+					if (a.kind == Operand::Ratio)
+						return floatResult((ratioReduce<VecMath::Add>(a.rptr, a.size, 0) / Rational((int64_t)a.size)).to_double());
+					return floatResult(VecMath::mean(a.iptr, a.size));
+				});
+			}
+			ObjectPtr dot(const DataList &dl) {
+				Operand a, b;
+				size_t n;
+				string err = prepare(dl, a, b, n);
+				if (!err.empty())
+					return createError(err);
+				if (a.scalar || b.scalar)
+					return createError("Dot product needs two sequences.");
+				switch (a.kind) {
+				case Operand::Int: {
+					int64_t r;
+					if (VecMath::dot(a.iptr, b.iptr, n, r))
+						return intResult(r);
+					a.promote(Operand::Ratio);
+					b.promote(Operand::Ratio);
 				}
-				ObjectPtr func(const DataList &list) const {
-					Object *tmp = list.front()->clone();
-					for (auto i : Range<size_t>(1, list.size()))
-						fp(tmp->dat<T_Number>(), list[i]->dat<T_Number>());
-					return ObjectPtr(tmp);
+				// fall through
+				case Operand::Ratio: {
+					Rational r;
+					for (size_t i : range(0, n))
+						if ((r += a.rptr[i] * b.rptr[i]).isNaN())
+							break;
+					return ratioResult(r);
 				}
-				Func fp;
-			};
-			struct Sub : public NumCall { Sub() : NumCall([](N &n1, const N &n2) { n1 -= n2; }) {} };
-			struct Mul : public NumCall { Mul() : NumCall([](N &n1, const N &n2) { n1 *= n2; }) {} };
-			struct Div : public NumCall { Div() : NumCall([](N &n1, const N &n2) { n1 /= n2; }) {} };
-
-			struct Mod : public FI
-			{
-			private:
-				S sign() const {
-					return S({ T_Number, T_Number }, T_Number); // (N N) -> N
+				default:
+					return floatResult(VecMath::dot(a.dptr, b.dptr, n));
 				}
-				ObjectPtr func(const DataList &list) const {
-					const auto &rr = Common::Number::mod(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
-					return ObjectPtr(new Number((int_t)rr.num()));
+			}
+		}
+
+		//=======================================
+		// * Maps
+		//=======================================
+		namespace Maps
+		{
+			ObjectPtr keyError(Object *key) {
+				return createError("Unhashable key '" + key->to_string() + "'.");
+			}
+
+			ObjectPtr create(const DataList &dl) {
+				if (dl.size() % 2 != 0)
+					return createError("Map needs pairs of key and value.");
+				MapType mt;
+				mt.reserve(dl.size() / 2);
+				for (size_t i = 0; i < dl.size(); i += 2) {
+					if (!dl[i]->hashable())
+						return keyError(dl[i]);
+					mt.insert(dl[i], dl[i + 1]);
 				}
-			};
-			struct Rem : public FI
+				return ObjectPtr(new Objects::Map(mt));
+			}
+
+			struct Get : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_Number, T_Number }, T_Number); // (N N) -> N
+					return S({ T_Map, T_Vary }, T_Vary); // (M K) -> V
 				}
 				ObjectPtr func(const DataList &list) const {
-					const auto &rr = Common::Number::rem(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
-					return ObjectPtr(new Number((int_t)rr.num()));
+					if (!list[1]->hashable())
+						return keyError(list[1]);
+					Object *value = list[0]->get<T_Map>()->find(list[1]);
+					return ObjectPtr(value ? value : &Static.Nil);
 				}
 			};
-			struct Gcd : public FI
+
+			struct GetDefault : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_Number, T_Number }, T_Number); // (N N) -> N
+					return S({ T_Map, T_Vary, T_Vary }, T_Vary); // (M K V) -> V
 				}
 				ObjectPtr func(const DataList &list) const {
-					const auto &rr = Common::Number::gcd(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
-					return ObjectPtr(new Number((int_t)rr.num()));
+					if (!list[1]->hashable())
+						return keyError(list[1]);
+					Object *value = list[0]->get<T_Map>()->find(list[1]);
+					return ObjectPtr(value ? value : list[2]);
 				}
 			};
 
-			struct Inc : public FI
+			struct Put : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_Number }, T_Number); // N -> N
+					return S({ T_Map, T_Vary, T_Vary }, T_Map); // (M K V) -> M
 				}
 				ObjectPtr func(const DataList &list) const {
-					const auto &r1 = list[0]->dat<T_Number>();
-					return ObjectPtr(new Number(r1 + 1));
+					if (!list[1]->hashable())
+						return keyError(list[1]);
+					list[0]->get<T_Map>()->insert(list[1], list[2]);
+					return list[0];
 				}
 			};
-			struct Dec : public FI
+
+			struct Remove : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_Number }, T_Number); // N -> N
+					return S({ T_Map, T_Vary }, T_Boolean); // (M K) -> Bool
 				}
 				ObjectPtr func(const DataList &list) const {
-					const auto &r1 = list[0]->dat<T_Number>();
-					return ObjectPtr(new Number(r1 - 1));
+					if (!list[1]->hashable())
+						return keyError(list[1]);
+					return ObjectPtr(new Boolean(list[0]->get<T_Map>()->erase(list[1])));
 				}
 			};
-		}
 
-		//=======================================
-		// * Compare
-		//=======================================
-		namespace Comp
-		{
-			struct NumComp : public FI
+			struct Contains : public FI
 			{
-			public:
-				using N = Types::Number;
-				using Func = std::function<bool(const N&, const N&)>;
-				NumComp(const Func &fp) : fp(fp) {}
-
 			private:
 				S sign() const {
-					return S({ T_Number, T_Number }, T_Boolean); // (N N) -> Bool
+					return S({ T_Map, T_Vary }, T_Boolean); // (M K) -> Bool
 				}
 				ObjectPtr func(const DataList &list) const {
-					bool result = fp(list[0]->dat<T_Number>(), list[1]->dat<T_Number>());
-					return ObjectPtr(new Boolean(result));
-				}
-				void funcL(Object* &result, const LDataList &list) const {
-					funcB(result, list[0], list[1]);
+					if (!list[1]->hashable())
+						return keyError(list[1]);
+					return ObjectPtr(new Boolean(list[0]->get<T_Map>()->contains(list[1])));
 				}
-				void funcB(Object* &result, Object *a, Object *b) const {
-					bool r = fp(a->dat<T_Number>(), b->dat<T_Number>());
-					result = new Boolean(r);
-				}
-				Func fp;
 			};
-			struct NumSmallS : public NumComp { NumSmallS() : NumComp([](const N &n1, const N &n2) { return n1 < n2; }) {} };
-			struct NumSmallE : public NumComp { NumSmallE() : NumComp([](const N &n1, const N &n2) { return n1 <= n2; }) {} };
-			struct NumLargeL : public NumComp { NumLargeL() : NumComp([](const N &n1, const N &n2) { return n1 > n2; }) {} };
-			struct NumLargeE : public NumComp { NumLargeE() : NumComp([](const N &n1, const N &n2) { return n1 >= n2; }) {} };
 
-			struct Equ : public FI
+			struct Size : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_Vary, T_Vary }, T_Boolean); // (Var Var) -> Boolean
+					return S({ T_Map }, T_Number); // M -> N
 				}
 				ObjectPtr func(const DataList &list) const {
-					auto &nn1 = list[0];
-					auto &nn2 = list[1];
-					return ObjectPtr(new Boolean(nn1->equ(nn2)));
+					size_t s = list[0]->get<T_Map>()->size();
+					return ObjectPtr(new Number(NumberType(s)));
 				}
 			};
+
+			// Iteration
+			ObjectPtr keys(const DataList &dl) {
+				const MapType &mt = dl[0]->dat<T_Map>();
+				ListType lt;
+				lt.reserve(mt.size());
+				for (const auto &e : mt)
+					lt.push(e.first);
+				return ObjectPtr(new List(lt));
+			}
+			ObjectPtr values(const DataList &dl) {
+				const MapType &mt = dl[0]->dat<T_Map>();
+				ListType lt;
+				lt.reserve(mt.size());
+				for (const auto &e : mt)
+					lt.push(e.second);
+				return ObjectPtr(new List(lt));
+			}
+			ObjectPtr items(const DataList &dl) {
+				const MapType &mt = dl[0]->dat<T_Map>();
+				ListType lt;
+				lt.reserve(mt.size());
+				for (const auto &e : mt)
+					lt.push(new List(ListType(vector<Object*>{ e.first, e.second })));
+				return ObjectPtr(new List(lt));
+			}
 		}
+
 		//=======================================
-		// * Lists
+		// * OrdMaps
 		//=======================================
-		namespace Lists
+		namespace OrdMaps
 		{
-			using L = List;
-
-			ObjectPtr list(const DataList &dl) {
-				return ObjectPtr(new List(ListType(dl)));
+			ObjectPtr keyError(Object *key) {
+				return createError("Ordered map key should be Number, String or Symbol, but got '" + key->to_string() + "'.");
 			}
 
-			const vector<Object*>& _disp(const ListType *l) {
-				return l->getData();
+			ObjectPtr create(const DataList &dl) {
+				if (dl.size() % 2 != 0)
+					return createError("Map needs pairs of key and value.");
+				OrdMapType mt;
+				for (size_t i = 0; i < dl.size(); i += 2) {
+					if (!OrdMapType::isKey(dl[i]))
+						return keyError(dl[i]);
+					mt.insert(dl[i], dl[i + 1]);
+				}
+				return ObjectPtr(new OrdMap(mt));
 			}
-
-			ObjectPtr disp(const DataList &dl) {
-				return ObjectPtr(new Disperse(DisperseType(_disp(dl[0]->get<T_List>()))));
+			// From a list of [key value], as items gives.
+			// A list sorted by key is loaded in linear time.
+			ObjectPtr list_to_omap(const DataList &dl) {
+				const ListType &lt = dl[0]->dat<T_List>();
+				vector<std::pair<Object*, Object*>> entries;
+				entries.reserve(lt.size());
+				for (Object *op : lt.getData()) {
+					if (op->type != T_List || op->dat<T_List>().size() != 2)
+						return createError("Ordered map needs [key value] lists, but got '" + op->to_string() + "'.");
+					const ListType &item = op->dat<T_List>();
+					if (!OrdMapType::isKey(item.at(0)))
+						return keyError(item.at(0));
+					entries.emplace_back(item.at(0), item.at(1));
+				}
+				OrdMapType mt;
+				if (!mt.assign_sorted(entries))
+					for (const auto &e : entries)
+						mt.insert(e.first, e.second);
+				return ObjectPtr(new OrdMap(mt));
 			}
 
-			ObjectPtr sort(const DataList &dl) {
-				Types::List *list = dl[0]->get<T_List>();
-				std::sort(list->begin(), list->end(), [](const ObjectPtr &a, const ObjectPtr &b) {
-					return a->dat<T_Number>() < b->dat<T_Number>();
-				});
-				return ObjectPtr(dl[0]);
-			}
-			// TODO
-			ObjectPtr sort_f(const DataList &dl) {
-				auto &func = dl[1]->get<T_Function>()->getData();
-				// TODO
-				size_t id = getCallID(func, DataList({ &Static.Zero, &Static.Zero }));
-				const auto &rf = func[id];
-
-				Types::List *list = dl[0]->get<T_List>();
-				ObjectPtr r;
-				std::sort(list->begin(), list->end(), [&](const ObjectPtr &a, const ObjectPtr &b) -> bool {
-					r = rf.call(DataList{ a.get(), b.get() });
-					bool rr = *r->get<T_Boolean>();
-					return rr;
-				});
-				return ObjectPtr(dl[0]);
+			Object* item(const OrdMapType::const_iterator &it) {
+				return new List(ListType(vector<Object*>{ it.key(), it.value() }));
 			}
 
-			class Mul : public FI
+			struct Get : public FI
 			{
+			private:
 				S sign() const {
-					return S({ T_List, T_Number }, T_List); // (L N) -> L
+					return S({ T_OrdMap, T_Vary }, T_Vary); // (O K) -> V
 				}
 				ObjectPtr func(const DataList &list) const {
-					auto &l = *list[0]->get<T_List>();
-					vector<Object*> nl;
-					for (size_t i : Range<size_t>(0, (size_t)list[1]->dat<T_Number>()/*->getNum()*/)) {
-						nl.insert(nl.end(), l.begin(), l.end());
-					}
-					return ObjectPtr(new List(ListType(nl)));
+					if (!OrdMapType::isKey(list[1]))
+						return keyError(list[1]);
+					Object *value = list[0]->dat<T_OrdMap>().find(list[1]);
+					return ObjectPtr(value ? value : &Static.Nil);
 				}
 			};
 
-			class Reserve : public FI
+			struct GetDefault : public FI
 			{
+			private:
 				S sign() const {
-					return S({ T_List, T_Number }, T_List); // (L N) -> L
+					return S({ T_OrdMap, T_Vary, T_Vary }, T_Vary); // (O K V) -> V
 				}
 				ObjectPtr func(const DataList &list) const {
-					ListType &l = *list[0]->get<T_List>();
-					l.reserve(*list[1]->get<T_Number>());
-					return list[0];
+					if (!OrdMapType::isKey(list[1]))
+						return keyError(list[1]);
+					Object *value = list[0]->dat<T_OrdMap>().find(list[1]);
+					return ObjectPtr(value ? value : list[2]);
 				}
 			};
 
-			class Capacity : public FI
+			struct Put : public FI
 			{
+			private:
 				S sign() const {
-					return S({ T_List }, T_Number); // L -> N
+					return S({ T_OrdMap, T_Vary, T_Vary }, T_OrdMap); // (O K V) -> O
 				}
 				ObjectPtr func(const DataList &list) const {
-					ListType &l = *list[0]->get<T_List>();
-					return ObjectPtr(new Number(NumberType(l.capacity())));
+					if (!OrdMapType::isKey(list[1]))
+						return keyError(list[1]);
+					list[0]->get<T_OrdMap>()->insert(list[1], list[2]);
+					return list[0];
 				}
 			};
 
-			class Push : public FI
+			struct Remove : public FI
 			{
+			private:
 				S sign() const {
-					return S({ T_List, T_Vary }, T_List); // (L V) -> L
+					return S({ T_OrdMap, T_Vary }, T_Boolean); // (O K) -> Bool
 				}
 				ObjectPtr func(const DataList &list) const {
-					ListType &l = *list[0]->get<T_List>();
-					l.push(list[1]);
-					return list[0];
+					if (!OrdMapType::isKey(list[1]))
+						return keyError(list[1]);
+					return ObjectPtr(new Boolean(list[0]->get<T_OrdMap>()->erase(list[1])));
 				}
 			};
 
-			struct Foreach : public FI
+			struct Contains : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T(T_Function,S({ T_Vary },T_Vary,true)), T_List }, T_List, true); // (F(V*->V) L*) -> L
+					return S({ T_OrdMap, T_Vary }, T_Boolean); // (O K) -> Bool
 				}
 				ObjectPtr func(const DataList &list) const {
-					// TODO
-					auto &func = list[0]->get<T_Function>()->getData();
-					size_t id = getCallID(func, DataList({ &Static.Zero }));
-					const auto &rf = func[id];
-
-					size_t minsize = list[1]->get<T_List>()->size();
-					size_t size = list.size();
-					for (auto i : range(1, size))
-						minsize = std::min(minsize, list[i]->get<T_List>()->size());
-					vector<Object*> dls;
-					Object obj;
-					for (size_t i : range(0, minsize)) {
-						DataList ldl(size - 1);
-						for (auto id : range(1, size))
-							ldl[id - 1] = list[id]->get<T_List>()->getData()[i];
-						dls.push_back(rf.call(ldl).get());
-					}
-					List *result = new List(ListType(dls));
-					return ObjectPtr(result);
+					if (!OrdMapType::isKey(list[1]))
+						return keyError(list[1]);
+					return ObjectPtr(new Boolean(list[0]->dat<T_OrdMap>().contains(list[1])));
 				}
 			};
 
@@ -371,85 +2196,285 @@ namespace ICM
 			{
 			private:
 				S sign() const {
-					return S({ T_List }, T_Number); // L -> N
+					return S({ T_OrdMap }, T_Number); // O -> N
 				}
 				ObjectPtr func(const DataList &list) const {
-					size_t s = list[0]->get<T_List>()->getData().size();
+					size_t s = list[0]->dat<T_OrdMap>().size();
 					return ObjectPtr(new Number(NumberType(s)));
 				}
 			};
 
-			struct Swap : public FI
-			{
-			private:
-				S sign() const {
-					return S({ T_List, T_Number, T_Number }, T_List); // (L N N) -> L
-				}
-				ObjectPtr func(const DataList &list) const {
-					auto &v = const_cast<vector<Object*>&>(list[0]->get<T_List>()->getData());
-					size_t i1 = (size_t)list[1]->dat<T_Number>()/*->getNum()*/;
-					size_t i2 = (size_t)list[2]->dat<T_Number>()/*->getNum()*/;
-					Object* top = v[i1];
-					v[i1] = v[i2];
-					v[i2] = top;
-					return list[0];
-				}
-			};
+			// Iteration, in key order.
+			ObjectPtr keys(const DataList &dl) {
+				const OrdMapType &mt = dl[0]->dat<T_OrdMap>();
+				ListType lt;
+				lt.reserve(mt.size());
+				for (auto it = mt.begin(); it != mt.end(); ++it)
+					lt.push(it.key());
+				return ObjectPtr(new List(lt));
+			}
+			ObjectPtr values(const DataList &dl) {
+				const OrdMapType &mt = dl[0]->dat<T_OrdMap>();
+				ListType lt;
+				lt.reserve(mt.size());
+				for (auto it = mt.begin(); it != mt.end(); ++it)
+					lt.push(it.value());
+				return ObjectPtr(new List(lt));
+			}
+			ObjectPtr items(const DataList &dl) {
+				const OrdMapType &mt = dl[0]->dat<T_OrdMap>();
+				ListType lt;
+				lt.reserve(mt.size());
+				for (auto it = mt.begin(); it != mt.end(); ++it)
+					lt.push(item(it));
+				return ObjectPtr(new List(lt));
+			}
 
-			struct At : public FI
+			// The least [key value] whose key is not less than the given, or nil.
+			ObjectPtr lower_bound(const DataList &dl) {
+				if (!OrdMapType::isKey(dl[1]))
+					return keyError(dl[1]);
+				const OrdMapType &mt = dl[0]->dat<T_OrdMap>();
+				auto it = mt.lower_bound(dl[1]);
+				return ObjectPtr(it == mt.end() ? &Static.Nil : item(it));
+			}
+			// The [key value] items with keys in [low, high).
+			ObjectPtr scan(const DataList &dl) {
+				if (!OrdMapType::isKey(dl[1]))
+					return keyError(dl[1]);
+				if (!OrdMapType::isKey(dl[2]))
+					return keyError(dl[2]);
+				const OrdMapType &mt = dl[0]->dat<T_OrdMap>();
+				ListType lt;
+				for (auto it = mt.lower_bound(dl[1]); it != mt.end() && OrdMapType::compareKey(it.key(), dl[2]) < 0; ++it)
+					lt.push(item(it));
+				return ObjectPtr(new List(lt));
+			}
+		}
+
+		namespace IO
+		{
+			ObjectPtr read(const DataList &dl) {
+				static char buffer[0xff] = { 0 };
+				std::fgets(buffer, 0xff, stdin);
+				return ObjectPtr(new String(buffer));
+			}
+		}
+
+		//=======================================
+		// * Randoms
+		//---------------------------------------
+		//   Draws from GlobalRandom.
+		//=======================================
+		namespace Randoms
+		{
+			// An integer in [least, max of int64].
+			bool toInteger(const Object *op, int64_t least, int64_t &v) {
+				const Rational &r = op->dat<T_Number>();
+				if (!r.isInteger() || r.num() < least)
+					return false;
+				v = r.num();
+				return true;
+			}
+			ObjectPtr boundError(const Object *op) {
+				return createError("'" + op->to_string() + "' is not a positive integer.");
+			}
+			ObjectPtr countError(const Object *op) {
+				return createError("'" + op->to_string() + "' is not a count.");
+			}
+
+			// An integer in [0, n).
+			struct Rand : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_List, T_Number }, T_Vary); // (L N) -> V
+					return S({ T_Number }, T_Number); // N -> N
 				}
 				ObjectPtr func(const DataList &list) const {
-					const TypeBase::ListType &lt = list[0]->dat<T_List>();
-					size_t id = list[1]->dat<T_Number>()/*->getNum()*/;
-					const ObjectPtr &op = lt.getData()[id];
-					return op;
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					int64_t bound;
+					if (!toInteger(list[0], 1, bound)) {
+						result = boundError(list[0]).get();
+						return true;
+					}
+					resultSlot<T_Number>(result) = NumberType((int64_t)GlobalRandom.below(bound));
+					return true;
 				}
 			};
 
-			struct Set : public FI
-			{
-			private:
-				S sign() const {
-					return S({ T_List, T_Number, T_Vary }, T_Vary); // (L N V) -> V
-				}
-				ObjectPtr func(const DataList &list) const {
-					const ObjectPtr &op = list[0]->get<T_List>()->getData()[(size_t)list[1]->dat<T_Number>()/*->getNum()*/];
-					ObjectPtr &rop = const_cast<ObjectPtr&>(op);
-					rop = list[2];
-					return rop;
+			// The same seed gives the same draws.
+			ObjectPtr seed(const DataList &dl) {
+				const Rational &r = dl[0]->dat<T_Number>();
+				if (!r.isInteger())
+					return Calc::integerError(dl[0]);
+				GlobalRandom.seed((uint64_t)r.num());
+				return ObjectPtr(&Static.Nil);
+			}
+
+			// n integers in [0, max).
+			ObjectPtr rand_list(const DataList &dl) {
+				int64_t count, bound;
+				if (!toInteger(dl[0], 0, count))
+					return countError(dl[0]);
+				if (!toInteger(dl[1], 1, bound))
+					return boundError(dl[1]);
+				Object *ops = newObjects<T_Number>(count);
+				vector<Object*> r(count);
+				for (size_t i : range(0, (size_t)count)) {
+					ops[i].dat<T_Number>() = NumberType((int64_t)GlobalRandom.below(bound));
+					r[i] = ops + i;
 				}
-			};
+				return ObjectPtr(new List(ListType(r)));
+			}
+
+			// Shuffle the list in place (Fisher-Yates).
+			ObjectPtr shuffle(const DataList &dl) {
+				ListType &lt = *dl[0]->get<T_List>();
+				for (size_t i = lt.size(); i > 1; i--)
+					std::swap(lt.begin()[i - 1], lt.begin()[GlobalRandom.below(i)]);
+				return ObjectPtr(dl[0]);
+			}
+
+			// k elements of the list at distinct positions, in random order.
+			ObjectPtr sample(const DataList &dl) {
+				const auto &data = dl[0]->dat<T_List>().getData();
+				int64_t count;
+				if (!toInteger(dl[1], 0, count) || (uint64_t)count > data.size())
+					return createError("Cannot sample '" + dl[1]->to_string() + "' of " + std::to_string(data.size()) + " elements.");
+				vector<Object*> r(data.begin(), data.end());
+				for (size_t i : range(0, (size_t)count))
+					std::swap(r[i], r[i + GlobalRandom.below(r.size() - i)]);
+				r.resize(count);
+				return ObjectPtr(new List(ListType(r)));
+			}
 		}
 
-		namespace IO
+		//=======================================
+		// * Maths
+		//=======================================
+		namespace Maths
 		{
-			ObjectPtr read(const DataList &dl) {
-				static char buffer[0xff] = { 0 };
-				std::fgets(buffer, 0xff, stdin);
-				return ObjectPtr(new String(buffer));
+			template <double(*f)(double)>
+			ObjectPtr call(const DataList &dl) {
+				return ObjectPtr(new Objects::Double(f(Calc::toDouble(dl[0]))));
+			}
+
+			ObjectPtr exact(const DataList &dl) {
+				return ObjectPtr(new Number(Rational::from_double(dl[0]->dat<T_Double>())));
+			}
+			ObjectPtr inexact(const DataList &dl) {
+				return ObjectPtr(new Objects::Double(dl[0]->dat<T_Number>().to_double()));
+			}
+		}
+
+		//=======================================
+		// * Bits
+		//---------------------------------------
+		//   Numbers act as Int64 for the bitwise operators,
+		//   and shift exactly.
+		//=======================================
+		namespace Bits
+		{
+			template <FixedInt::Operator Op>
+			ObjectPtr calc(const DataList &dl) {
+				TypeUnit type;
+				string err = Calc::fixedType(dl, type);
+				if (!err.empty())
+					return createError(err);
+				if (type != T_Null)
+					return Calc::fixedCall(type, Op, dl);
+				for (Object *op : dl)
+					if (op->type != T_Number || !op->dat<T_Number>().isInteger())
+						return createError("'" + op->to_string() + "' is not an Int64 range integer.");
+				ObjectPtr r = Calc::fixedCall(T_Int64, Op, dl);
+				return ObjectPtr(new Number(NumberType(r->dat<T_Int64>())));
 			}
-			ObjectPtr rand(const DataList &dl) {
-				auto ii = dl[0]->dat<T_Number>();
-				int i = random_base(ii, std::rand);
-				return ObjectPtr(new Number(i));
+			ObjectPtr bnot(const DataList &dl) {
+				Object *op = dl[0];
+				if (FixedInt::isFixedInt(op->type))
+					return ObjectPtr(FixedInt::box(op->type, ~FixedInt::load(op)));
+				if (op->type != T_Number || !op->dat<T_Number>().isInteger())
+					return createError("'" + op->to_string() + "' is not an Int64 range integer.");
+				return ObjectPtr(new Number(NumberType(~op->dat<T_Number>().num())));
+			}
+
+			template <FixedInt::Operator Op>
+			ObjectPtr shift(const DataList &dl) {
+				Object *op = dl[0];
+				uint64_t n;
+				if (!Calc::isNumeric(dl[1]) || dl[1]->type == T_Double || !FixedInt::fromNumber(T_Int64, Calc::toExact(dl[1]), n) || (int64_t)n < 0)
+					return createError("Shift count '" + dl[1]->to_string() + "' should be a non-negative integer.");
+				if (FixedInt::isFixedInt(op->type)) {
+					uint64_t r;
+					FixedInt::calc(op->type, Op, FixedInt::load(op), n, r);
+					return ObjectPtr(FixedInt::box(op->type, r));
+				}
+				if (op->type != T_Number || op->dat<T_Number>().floor() != op->dat<T_Number>())
+					return Calc::integerError(op);
+				const Rational &v = op->dat<T_Number>();
+				// 2^n by squaring.
+				Rational p(1), b(2);
+				for (uint64_t k = n; k != 0; k >>= 1) {
+					if (k & 1)
+						p *= b;
+					if (k > 1)
+						b *= b;
+				}
+				return ObjectPtr(new Number(Op == FixedInt::Shl ? v * p : (v / p).floor()));
 			}
 		}
 
 		namespace Convert
 		{
+			// Fixed-width integers wrap around, and the others are truncated toward zero first.
+			ObjectPtr cast(const DataList &dl) {
+				TypeUnit type = dl[0]->get<T_Type>()->get();
+				Object *op = dl[1];
+				if (!Calc::isNumeric(op))
+					return Calc::numericError(op);
+				if (type == T_Double)
+					return ObjectPtr(new Objects::Double(Calc::toDouble(op)));
+				if (type == T_Number || FixedInt::isFixedInt(type)) {
+					if (FixedInt::isFixedInt(op->type) && type != T_Number)
+						return ObjectPtr(FixedInt::box(type, FixedInt::normalize(type, FixedInt::load(op))));
+					Rational r = Calc::toExact(op);
+					uint64_t v;
+					if (r.isNaN() || (type != T_Number && !FixedInt::fromNumber(type, r.trunc(), v)))
+						return createError("Cannot cast '" + op->to_string() + "' to '" + string(TypeInfoTable.at(type).name) + "'.");
+					return ObjectPtr(type == T_Number ? new Number(r) : FixedInt::box(type, v));
+				}
+				return createError("Cannot cast to '" + string(TypeInfoTable.at(type).name) + "'.");
+			}
+
 			struct StringToNumber : public FI
 			{
 			private:
 				S sign() const {
-					return S({ T_String }, T_Number); // S -> N
+					return S({ T_String }, T_Vary); // S -> V
 				}
 				ObjectPtr func(const DataList &list) const {
-					TypeBase::NumberType num = (TypeBase::NumberType)Common::Number::to_rational<long long>(list[0]->dat<T_String>().c_str()).num();
-					return ObjectPtr(new Objects::Number(num));
+					const char *str = list[0]->dat<T_String>().c_str();
+					TypeBase::NumberType num;
+					if (Rational::parse(str, num))
+						return ObjectPtr(new Objects::Number(num));
+					uint64_t value;
+					Parser::NumberType type = Parser::parseNumber(str, value);
+					if (Parser::hasIntegerSuffix(str) && Parser::getIntegerType(type) != T_Null)
+						return ObjectPtr(FixedInt::box(Parser::getIntegerType(type), value));
+					switch (type) {
+					case Parser::nt_float:
+					case Parser::nt_double:
+						return ObjectPtr(new Objects::Double((double&)value));
+					case Parser::nt_int8:
+					case Parser::nt_int16:
+					case Parser::nt_int32:
+					case Parser::nt_int64:
+						return ObjectPtr(new Objects::Number(NumberType((int64_t)value)));
+					default:
+						return createError("'" + list[0]->to_output() + "' is not a number.");
+					}
 				}
 			};
 		}
@@ -495,6 +2520,12 @@ namespace ICM
 				int i = std::system(dl[0]->get<T_String>()->c_str());
 				return ObjectPtr(new Number(NumberType(i)));
 			}
+			ObjectPtr load_native(const DataList &dl) {
+				string err = NativeModule::load(dl[0]->dat<T_String>().c_str());
+				if (!err.empty())
+					return createError(err);
+				return ObjectPtr(&Static.Nil);
+			}
 			ObjectPtr exit(const DataList &dl) {
 				std::exit(0);
 				return ObjectPtr(&Static.Nil);
@@ -518,7 +2549,11 @@ namespace ICM
 					return S({ T_Boolean }, T_Boolean); // Bool -> Bool
 				}
 				ObjectPtr func(const DataList &list) const {
-					return ObjectPtr(new Boolean(!list[0]->dat<T_Boolean>()));
+					return funcByL(list);
+				}
+				bool funcL(Object* &result, const LDataList &list) const {
+					resultSlot<T_Boolean>(result) = !list[0]->dat<T_Boolean>();
+					return true;
 				}
 			};
 		}
@@ -583,30 +2618,32 @@ namespace ICM
 		DefFuncTable.insert("+", LST{
 			new Calc::Add<T_Void>(),
 			new Calc::Add<T_Number>(),
+			new Calc::Add<T_Double>(),
 			new Calc::Add<T_String>(),
 			new Calc::Add<T_List>(),
+			new Calc::MixedAdd(),
 		});
-		DefFuncTable.insert("-", LST{ new Calc::Sub() });
-		DefFuncTable.insert("*", LST{ new Calc::Mul(), new Lists::Mul() });
-		DefFuncTable.insert("/", LST{ new Calc::Div() });
+		DefFuncTable.insert("-", LST{ new Calc::Sub(), new Calc::MixedSub() });
+		DefFuncTable.insert("*", LST{ new Calc::Mul(), new Lists::Mul(), new Calc::MixedMul() });
+		DefFuncTable.insert("/", LST{ new Calc::Div(), new Calc::MixedDiv() });
 		DefFuncTable.insert("mod", LST{ new Calc::Mod() });
-		DefFuncTable.insert("rem", LST{ new Calc::Rem() });
+		DefFuncTable.insert("rem", LST{ new Calc::Rem(), new Calc::MixedRem() });
 		DefFuncTable.insert("gcd", LST{ new Calc::Gcd() });
 
 		DefFuncTable.insert("=", LST{ new Comp::Equ() });
-		DefFuncTable.insert("<", LST{ new Comp::NumSmallS() });
-		DefFuncTable.insert("<=", LST{ new Comp::NumSmallE() });
-		DefFuncTable.insert(">", LST{ new Comp::NumLargeL() });
-		DefFuncTable.insert(">=", LST{ new Comp::NumLargeE() });
+		Comp::SmallSID = DefFuncTable.insert("<", LST{ new Comp::NumSmallS(), new Comp::MixedSmallS() });
+		Comp::SmallEID = DefFuncTable.insert("<=", LST{ new Comp::NumSmallE(), new Comp::MixedSmallE() });
+		Comp::LargeLID = DefFuncTable.insert(">", LST{ new Comp::NumLargeL(), new Comp::MixedLargeL() });
+		Comp::LargeEID = DefFuncTable.insert(">=", LST{ new Comp::NumLargeE(), new Comp::MixedLargeE() });
 
 		DefFuncTable.insert("inc", LST{ new Calc::Inc() });
 		DefFuncTable.insert("dec", LST{ new Calc::Dec() });
 		DefFuncTable.insert("++", "inc");
 		DefFuncTable.insert("--", "dec");
 
-		DefFuncTable.insert("list", Lst{
-			F(Lists::list, S({}, T_List)),               // Void -> L
-			F(Lists::list, S({ T_Vary }, T_List, true)), // Var* -> L
+		DefFuncTable.insert("list", LST{
+			new Lists::Make(false), // Void -> L
+			new Lists::Make(true),  // Var* -> L
 		});
 		DefFuncTable.insert("disp", Lst{
 			F(Lists::disp, S({ T_List }, T_Disperse)),       // L -> D
@@ -614,15 +2651,188 @@ namespace ICM
 		DefFuncTable.insert("sort", Lst{
 			F(Lists::sort, S({ T_List }, T_List)), // L -> L
 			F(Lists::sort_f, S({ T_List, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (L F) -> L
+			F(Arrays::sort, S({ T_Array }, T_Array)), // A -> A
+			F(Slices::sort, S({ T_Slice }, T_List)), // S -> L
+			F(Slices::sort_f, S({ T_Slice, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (S F) -> L
+		});
+		DefFuncTable.insert("sort-stable", Lst{
+			F(Lists::sort_stable, S({ T_List }, T_List)), // L -> L
+			F(Lists::sort_stable_f, S({ T_List, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (L F) -> L
+			F(Slices::sort_stable, S({ T_Slice }, T_List)), // S -> L
+			F(Slices::sort_stable_f, S({ T_Slice, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (S F) -> L
+		});
+		DefFuncTable.insert("sort-by", Lst{
+			F(Lists::sort_by, S({ T_List, T(T_Function,S({ T_Vary },T_Vary)) }, T_List)),   // (L F) -> L
+			F(Slices::sort_by, S({ T_Slice, T(T_Function,S({ T_Vary },T_Vary)) }, T_List)), // (S F) -> L
+		});
+		DefFuncTable.insert("bsearch", Lst{
+			F(Lists::bsearch, S({ T_List, T_Vary }, T_Vary)), // (L V) -> V
+			F(Lists::bsearch, S({ T_List, T_Vary, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_Vary)), // (L V F) -> V
+		});
+		DefFuncTable.insert("merge", Lst{
+			F(Lists::merge, S({ T_List, T_List }, T_List)), // (L L) -> L
+			F(Lists::merge, S({ T_List, T_List, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (L L F) -> L
+		});
+		DefFuncTable.insert("union", Lst{
+			F(Lists::set_union, S({ T_List, T_List }, T_List)), // (L L) -> L
+			F(Lists::set_union, S({ T_List, T_List, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (L L F) -> L
 		});
-		DefFuncTable.insert("foreach", LST{ new Lists::Foreach() });
-		DefFuncTable.insert("size", LST{ new Lists::Size() });
-		DefFuncTable.insert("push", LST{ new Lists::Push() });
+		DefFuncTable.insert("intersect", Lst{
+			F(Lists::set_intersection, S({ T_List, T_List }, T_List)), // (L L) -> L
+			F(Lists::set_intersection, S({ T_List, T_List, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (L L F) -> L
+		});
+		DefFuncTable.insert("difference", Lst{
+			F(Lists::set_difference, S({ T_List, T_List }, T_List)), // (L L) -> L
+			F(Lists::set_difference, S({ T_List, T_List, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_List)), // (L L F) -> L
+		});
+		DefFuncTable.insert("foreach", LST{ new Lists::Foreach<T_List>(), new Lists::Foreach<T_Slice>() });
+		DefFuncTable.insert("size", LST{ new Lists::Size(), new Arrays::Size(), new PVectors::Size(), new Slices::Size(), new Deques::Size(), new PQueues::Size(), new Maps::Size(), new OrdMaps::Size() });
+		DefFuncTable.insert("push", LST{ new Lists::Push(), new Arrays::Push(), new Deques::Push() });
 		DefFuncTable.insert("reserve", LST{ new Lists::Reserve() });
 		DefFuncTable.insert("capacity", LST{ new Lists::Capacity() });
 		DefFuncTable.insert("swap", LST{ new Lists::Swap() });
-		DefFuncTable.insert("at", LST{ new Lists::At() });
-		DefFuncTable.insert("set", LST{ new Lists::Set() });
+		DefFuncTable.insert("at", LST{ new Lists::At(), new Arrays::At(), new PVectors::At(), new Slices::At(), new Deques::At() });
+		DefFuncTable.insert("set", LST{ new Lists::Set(), new Arrays::Set(), new Slices::Set(), new Deques::Set() });
+		DefFuncTable.insert("make-array", Lst{
+			F(Arrays::create, S({ T_Type }, T_Array)),           // T -> A
+			F(Arrays::create_l, S({ T_Type, T_List }, T_Array)), // (T L) -> A
+		});
+		DefFuncTable.insert("list->array", Lst{
+			F(Arrays::list_to_array, S({ T_List, T_Type }, T_Array)), // (L T) -> A
+		});
+		DefFuncTable.insert("array->list", Lst{
+			F(Arrays::array_to_list, S({ T_Array }, T_List)), // A -> L
+		});
+		DefFuncTable.insert("pvec", Lst{
+			F(PVectors::create, S({}, T_PVector)),               // Void -> P
+			F(PVectors::create, S({ T_Vary }, T_PVector, true)), // Var* -> P
+		});
+		DefFuncTable.insert("list->pvec", Lst{
+			F(PVectors::list_to_pvec, S({ T_List }, T_PVector)), // L -> P
+		});
+		DefFuncTable.insert("pvec->list", Lst{
+			F(PVectors::pvec_to_list, S({ T_PVector }, T_List)), // P -> L
+		});
+		DefFuncTable.insert("slice", Lst{
+			F(Slices::slice, S({ T_List, T_Number }, T_Slice)),                        // (L N) -> S
+			F(Slices::slice, S({ T_List, T_Number, T_Number }, T_Slice)),              // (L N N) -> S
+			F(Slices::slice, S({ T_List, T_Number, T_Number, T_Number }, T_Slice)),    // (L N N N) -> S
+			F(Slices::slice_s, S({ T_Slice, T_Number }, T_Slice)),                     // (S N) -> S
+			F(Slices::slice_s, S({ T_Slice, T_Number, T_Number }, T_Slice)),           // (S N N) -> S
+			F(Slices::slice_s, S({ T_Slice, T_Number, T_Number, T_Number }, T_Slice)), // (S N N N) -> S
+		});
+		DefFuncTable.insert("slice->list", Lst{
+			F(Slices::slice_to_list, S({ T_Slice }, T_List)), // S -> L
+		});
+		DefFuncTable.insert("deque", Lst{
+			F(Deques::create, S({}, T_Deque)),               // Void -> Q
+			F(Deques::create, S({ T_Vary }, T_Deque, true)), // Var* -> Q
+		});
+		DefFuncTable.insert("list->deque", Lst{
+			F(Deques::list_to_deque, S({ T_List }, T_Deque)), // L -> Q
+		});
+		DefFuncTable.insert("deque->list", Lst{
+			F(Deques::deque_to_list, S({ T_Deque }, T_List)), // Q -> L
+		});
+		DefFuncTable.insert("push-front", Lst{ F(Deques::push_front, S({ T_Deque, T_Vary }, T_Deque)) }); // (Q V) -> Q
+		DefFuncTable.insert("push-back", Lst{ F(Deques::push_back, S({ T_Deque, T_Vary }, T_Deque)) });   // (Q V) -> Q
+		DefFuncTable.insert("pop-front", Lst{ F(Deques::pop_front, S({ T_Deque }, T_Vary)) }); // Q -> V
+		DefFuncTable.insert("pop-back", Lst{ F(Deques::pop_back, S({ T_Deque }, T_Vary)) });   // Q -> V
+		DefFuncTable.insert("front", Lst{ F(Deques::front, S({ T_Deque }, T_Vary)) }); // Q -> V
+		DefFuncTable.insert("back", Lst{ F(Deques::back, S({ T_Deque }, T_Vary)) });   // Q -> V
+		DefFuncTable.insert("pqueue", Lst{ F(PQueues::create, S({}, T_PQueue)) }); // Void -> PQ
+		DefFuncTable.insert("pq-push", Lst{ F(PQueues::push, S({ T_PQueue, T_Vary, T_Vary }, T_PQueue)) }); // (PQ V V) -> PQ
+		DefFuncTable.insert("pq-pop", Lst{ F(PQueues::pop, S({ T_PQueue }, T_Vary)) });              // PQ -> V
+		DefFuncTable.insert("pq-top", Lst{ F(PQueues::top, S({ T_PQueue }, T_Vary)) });              // PQ -> V
+		DefFuncTable.insert("pq-priority", Lst{ F(PQueues::priority, S({ T_PQueue }, T_Vary)) });    // PQ -> V
+		DefFuncTable.insert("pqueue->list", Lst{ F(PQueues::pqueue_to_list, S({ T_PQueue }, T_List)) }); // PQ -> L
+		DefFuncTable.insert("assoc", LST{ new PVectors::Assoc() });
+		DefFuncTable.insert("conj", LST{ new PVectors::Conj() });
+		DefFuncTable.insert("v+", Lst{ F(Vectors::calc<VecMath::Add>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v-", Lst{ F(Vectors::calc<VecMath::Sub>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v*", Lst{ F(Vectors::calc<VecMath::Mul>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v/", Lst{ F(Vectors::calc<VecMath::Div>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("vmin", Lst{ F(Vectors::calc<VecMath::Min>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("vmax", Lst{ F(Vectors::calc<VecMath::Max>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v<", Lst{ F(Vectors::compare<VecMath::Less>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v<=", Lst{ F(Vectors::compare<VecMath::LessEqual>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v>", Lst{ F(Vectors::compare<VecMath::Greater>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v>=", Lst{ F(Vectors::compare<VecMath::GreaterEqual>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v=", Lst{ F(Vectors::compare<VecMath::Equal>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("v!=", Lst{ F(Vectors::compare<VecMath::NotEqual>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("sum", Lst{ F(Vectors::sum, S({ T_Vary }, T_Vary)) });
+		DefFuncTable.insert("sum-exact", Lst{ F(Vectors::sum_exact, S({ T_Vary }, T_Vary)) });
+		DefFuncTable.insert("product", Lst{ F(Vectors::product, S({ T_Vary }, T_Vary)) });
+		DefFuncTable.insert("min", Lst{ F(Vectors::min, S({ T_Vary }, T_Vary)) });
+		DefFuncTable.insert("max", Lst{ F(Vectors::max, S({ T_Vary }, T_Vary)) });
+		DefFuncTable.insert("mean", Lst{ F(Vectors::mean, S({ T_Vary }, T_Double)) });
+		DefFuncTable.insert("dot", Lst{ F(Vectors::dot, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("map", Lst{
+			F(Maps::create, S({}, T_Map)),               // Void -> M
+			F(Maps::create, S({ T_Vary }, T_Map, true)), // (K V)* -> M
+		});
+		DefFuncTable.insert("omap", Lst{
+			F(OrdMaps::create, S({}, T_OrdMap)),               // Void -> O
+			F(OrdMaps::create, S({ T_Vary }, T_OrdMap, true)), // (K V)* -> O
+		});
+		DefFuncTable.insert("list->omap", Lst{
+			F(OrdMaps::list_to_omap, S({ T_List }, T_OrdMap)), // L -> O
+		});
+		DefFuncTable.insert("get", LST{ new Maps::Get(), new Maps::GetDefault(), new OrdMaps::Get(), new OrdMaps::GetDefault() });
+		DefFuncTable.insert("put", LST{ new Maps::Put(), new OrdMaps::Put() });
+		DefFuncTable.insert("remove", LST{ new Maps::Remove(), new OrdMaps::Remove() });
+		DefFuncTable.insert("contains", LST{ new Maps::Contains(), new OrdMaps::Contains() });
+		DefFuncTable.insert("keys", Lst{
+			F(Maps::keys, S({ T_Map }, T_List)),      // M -> L
+			F(OrdMaps::keys, S({ T_OrdMap }, T_List)), // O -> L
+		});
+		DefFuncTable.insert("values", Lst{
+			F(Maps::values, S({ T_Map }, T_List)),      // M -> L
+			F(OrdMaps::values, S({ T_OrdMap }, T_List)), // O -> L
+		});
+		DefFuncTable.insert("items", Lst{
+			F(Maps::items, S({ T_Map }, T_List)),      // M -> L
+			F(OrdMaps::items, S({ T_OrdMap }, T_List)), // O -> L
+		});
+		DefFuncTable.insert("lower-bound", Lst{
+			F(OrdMaps::lower_bound, S({ T_OrdMap, T_Vary }, T_Vary)), // (O K) -> V
+			F(Lists::lower_bound, S({ T_List, T_Vary }, T_Number)), // (L V) -> N
+			F(Lists::lower_bound, S({ T_List, T_Vary, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_Number)), // (L V F) -> N
+		});
+		DefFuncTable.insert("upper-bound", Lst{
+			F(Lists::upper_bound, S({ T_List, T_Vary }, T_Number)), // (L V) -> N
+			F(Lists::upper_bound, S({ T_List, T_Vary, T(T_Function,S({ T_Number,T_Number },T_Number)) }, T_Number)), // (L V F) -> N
+		});
+		DefFuncTable.insert("range", Lst{
+			F(OrdMaps::scan, S({ T_OrdMap, T_Vary, T_Vary }, T_List)), // (O K K) -> L
+		});
+		DefFuncTable.insert("sqrt", Lst{
+			F(Maths::call<std::sqrt>, S({ T_Number }, T_Double)), // N -> D
+			F(Maths::call<std::sqrt>, S({ T_Double }, T_Double)), // D -> D
+		});
+		DefFuncTable.insert("exp", Lst{
+			F(Maths::call<std::exp>, S({ T_Number }, T_Double)),  // N -> D
+			F(Maths::call<std::exp>, S({ T_Double }, T_Double)),  // D -> D
+		});
+		DefFuncTable.insert("log", Lst{
+			F(Maths::call<std::log>, S({ T_Number }, T_Double)),  // N -> D
+			F(Maths::call<std::log>, S({ T_Double }, T_Double)),  // D -> D
+		});
+		DefFuncTable.insert("band", Lst{ F(Bits::calc<FixedInt::And>, S({ T_Vary }, T_Vary, true)) });
+		DefFuncTable.insert("bor", Lst{ F(Bits::calc<FixedInt::Or>, S({ T_Vary }, T_Vary, true)) });
+		DefFuncTable.insert("bxor", Lst{ F(Bits::calc<FixedInt::Xor>, S({ T_Vary }, T_Vary, true)) });
+		DefFuncTable.insert("bnot", Lst{ F(Bits::bnot, S({ T_Vary }, T_Vary)) });
+		DefFuncTable.insert("shl", Lst{ F(Bits::shift<FixedInt::Shl>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("shr", Lst{ F(Bits::shift<FixedInt::Shr>, S({ T_Vary, T_Vary }, T_Vary)) });
+		DefFuncTable.insert("cast", Lst{
+			F(Convert::cast, S({ T_Type, T_Vary }, T_Vary)), // (T V) -> V
+		});
+		DefFuncTable.insert("exact", Lst{
+			F(Maths::exact, S({ T_Double }, T_Number)),   // D -> N
+		});
+		DefFuncTable.insert("inexact", Lst{
+			F(Maths::inexact, S({ T_Number }, T_Double)), // N -> D
+		});
 		DefFuncTable.insert("string->number", LST{ new Convert::StringToNumber() });
 		DefFuncTable.insert("call", Lst{
 			F(System::call, S({ T_Function }, T_Vary)),    // F -> V
@@ -647,8 +2857,18 @@ namespace ICM
 		DefFuncTable.insert("gets", Lst{
 			F(IO::read, S({}, T_String)), // Void -> String
 		});
-		DefFuncTable.insert("rand", Lst{
-			F(IO::rand, S({ T_Number }, T_Number)), // Number -> Number
+		DefFuncTable.insert("rand", LST{ new Randoms::Rand() });
+		DefFuncTable.insert("seed", Lst{
+			F(Randoms::seed, S({ T_Number }, T_Nil)), // N -> Nil
+		});
+		DefFuncTable.insert("rand-list", Lst{
+			F(Randoms::rand_list, S({ T_Number, T_Number }, T_List)), // (N N) -> L
+		});
+		DefFuncTable.insert("shuffle", Lst{
+			F(Randoms::shuffle, S({ T_List }, T_List)), // L -> L
+		});
+		DefFuncTable.insert("sample", Lst{
+			F(Randoms::sample, S({ T_List, T_Number }, T_List)), // (L N) -> L
 		});
 		DefFuncTable.insert("type", LST{ new System::Type() });
 		DefFuncTable.insert("exit", Lst{
@@ -658,6 +2878,9 @@ namespace ICM
 		DefFuncTable.insert("system", Lst{
 			F(System::system, S({ T_String }, T_Number)), // S -> N
 		});
+		DefFuncTable.insert("load-native", Lst{
+			F(System::load_native, S({ T_String }, T_Nil)), // S -> Nil
+		});
 		DefFuncTable.insert("Config.SetDebugMode", LST{ new DefFunc::Config::DebugMode() });
 		DefFuncTable.insert("Config.SetPrintIntervalTime", LST{ new DefFunc::Config::PrintIntervalTime() });
 		DefFuncTable.insert("Config.PrintAST", LST{ new DefFunc::Config::PrintAST() });
@@ -0,0 +1,145 @@
+#include "basic.h"
+#include "runtime/fixedint.h"
+#include "runtime/objectdef.h"
+
+namespace ICM
+{
+	namespace FixedInt
+	{
+		bool isFixedInt(TypeUnit type) {
+			return width(type) != 0;
+		}
+		bool isSigned(TypeUnit type) {
+			switch (type) {
+			case T_Int:
+			case T_Int8:
+			case T_Int16:
+			case T_Int32:
+			case T_Int64:
+				return true;
+			default:
+				return false;
+			}
+		}
+		unsigned width(TypeUnit type) {
+			switch (type) {
+			case T_Int:
+			case T_UInt:   return sizeof(int_t) * 8;
+			case T_Byte:
+			case T_Int8:
+			case T_UInt8:  return 8;
+			case T_Word:
+			case T_Int16:
+			case T_UInt16: return 16;
+			case T_DWord:
+			case T_Int32:
+			case T_UInt32: return 32;
+			case T_QWord:
+			case T_Int64:
+			case T_UInt64: return 64;
+			default:       return 0;
+			}
+		}
+		uint64_t normalize(TypeUnit type, uint64_t v) {
+			unsigned w = width(type);
+			if (w == 64)
+				return v;
+			uint64_t mask = ((uint64_t)1 << w) - 1;
+			v &= mask;
+			if (isSigned(type) && (v >> (w - 1)) != 0)
+				v |= ~mask;
+			return v;
+		}
+
+		//=======================================
+		// * Unbox/Box
+		//=======================================
+#define FIXEDINT_CASES(_F) \
+	_F(Int) _F(UInt) _F(Byte) _F(Word) _F(DWord) _F(QWord) \
+	_F(Int8) _F(Int16) _F(Int32) _F(Int64) _F(UInt8) _F(UInt16) _F(UInt32) _F(UInt64)
+
+		uint64_t load(const Object *op) {
+			switch (op->type) {
+#define LOAD_CASE(_TE) case T_##_TE: return (uint64_t)op->dat<T_##_TE>();
+				FIXEDINT_CASES(LOAD_CASE)
+#undef LOAD_CASE
+			default:
+				assert(false);
+				return 0;
+			}
+		}
+		Object* box(TypeUnit type, uint64_t v) {
+			switch (type) {
+#define BOX_CASE(_TE) case T_##_TE: return new Objects::DataObject<T_##_TE>((Types::_TE)v);
+				FIXEDINT_CASES(BOX_CASE)
+#undef BOX_CASE
+			default:
+				assert(false);
+				return nullptr;
+			}
+		}
+		void box(Object* &result, TypeUnit type, uint64_t v) {
+			switch (type) {
+#define BOX_CASE(_TE) case T_##_TE: Objects::resultSlot<T_##_TE>(result) = (Types::_TE)v; break;
+				FIXEDINT_CASES(BOX_CASE)
+#undef BOX_CASE
+			default:
+				assert(false);
+			}
+		}
+#undef FIXEDINT_CASES
+
+		bool fromNumber(TypeUnit type, const Rational &n, uint64_t &r) {
+			if (!n.isInteger() && !(n.isBig() && n.floor() == n))
+				return false;
+			r = normalize(type, (uint64_t)n.to_int64());
+			return true;
+		}
+		Rational toNumber(TypeUnit type, uint64_t v) {
+			if (isSigned(type) || v <= (uint64_t)INT64_MAX)
+				return Rational((int64_t)v);
+			return Rational((int64_t)(v >> 1)) * 2 + Rational((int64_t)(v & 1));
+		}
+
+		//=======================================
+		// * Calculate
+		//=======================================
+		bool calc(TypeUnit type, Operator op, uint64_t a, uint64_t b, uint64_t &r) {
+			bool sign = isSigned(type);
+			unsigned w = width(type);
+			switch (op) {
+			case Add: r = a + b; break;
+			case Sub: r = a - b; break;
+			case Mul: r = a * b; break;
+			case Div:
+			case Rem:
+				if (b == 0)
+					return false;
+				if (sign) {
+					// INT64_MIN / -1 wraps around to INT64_MIN, with no remainder.
+					if ((int64_t)b == -1)
+						r = op == Div ? 0 - a : 0;
+					else
+						r = (uint64_t)(op == Div ? (int64_t)a / (int64_t)b : (int64_t)a % (int64_t)b);
+				}
+				else {
+					r = op == Div ? a / b : a % b;
+				}
+				break;
+			case And: r = a & b; break;
+			case Or:  r = a | b; break;
+			case Xor: r = a ^ b; break;
+			// The shift count is taken modulo the width.
+			case Shl: r = a << (b & (w - 1)); break;
+			case Shr: r = sign ? (uint64_t)((int64_t)a >> (b & (w - 1))) : a >> (b & (w - 1)); break;
+			}
+			r = normalize(type, r);
+			return true;
+		}
+		int compare(TypeUnit type, uint64_t a, uint64_t b) {
+			if (isSigned(type))
+				return (int64_t)a < (int64_t)b ? -1 : (int64_t)a > (int64_t)b;
+			return a < b ? -1 : a > b;
+		}
+	}
+}
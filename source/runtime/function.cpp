@@ -4,6 +4,7 @@
 #include "parser/keyword.h"
 #include "runtime/objectdef.h"
 #include <ctime>
+#include <chrono>
 size_t CheckCallCount = 0;
 
 namespace ICM
@@ -91,113 +92,155 @@ namespace ICM
 	}
 
 	//=======================================
-
-	const Function::SignTreeMatch::Node* Function::SignTreeMatch::checkSingle(const Node *data, const TypeObject &type, size_t &index) {
-		auto &vec = data->getChildren();
-		if (index == 0) {
-			for (size_t i : range(0, vec.size())) {
-				bool change = false;
-				auto *p = checkSingle(data, vec[i].get(), type, change);
-				if (p != nullptr) {
-					if (change) {
-						index = i + 1;
-					}
-					return p;
-				}
-			}
-		}
-		else {
-			const Node *p = vec[index - 1].get();
-			if (!p->isNull()) {
-				if (p->checkType(type)) {
-					return data;
-				}
-			}
-			return nullptr;
+	// * Class FuncInitObject
+	//=======================================
+	bool Function::FuncInitObject::funcV(Object **result, const Columns &columns, size_t length) const {
+		DataList row(columns.size());
+		for (size_t i : range(0, length)) {
+			for (size_t j : range(0, columns.size()))
+				row[j] = columns[j][i];
+			result[i] = nullptr;
+			if (!funcL(result[i], row))
+				return false;
 		}
-		return nullptr;
+		return true;
 	}
-	const Function::SignTreeMatch::Node* Function::SignTreeMatch::checkSingle(const Node *data, const Node *p, const TypeObject &type, bool &change) {
-		if (!p->isNull()) {
-			bool r;
-			if (p->isFunc())
-				r = (p->getSign().checkType(type.getSign()));
-			else
-				r = (p->checkType(type));
-			if (r) {
-				if (p->isArgs()) {
-					change = true;
-					return data;
-				}
-				else
-					return p;
+
+	//=======================================
+	// * Class SignTreeMatch
+	//=======================================
+	const Function::FuncObject* Function::SignTreeMatch::match(const lightlist<TypeObject> &argT) {
+		this->argT = &argT;
+		best = SIZE_MAX;
+		search(ST.getRoot(), 0);
+		return best != SIZE_MAX ? ST.getFunc(best) : nullptr;
+	}
+	void Function::SignTreeMatch::search(const Node *node, size_t pos) {
+		for (const auto &np : node->getChildren()) {
+			const Node *p = np.get();
+			// The rest can only hold later overloads.
+			if (p->getIndex() >= best)
+				break;
+			if (p->isNull()) {
+				if (pos == argT->size() || (p->isArgs() && matchArgs(node, pos)))
+					best = p->getIndex();
+			}
+			else if (pos < argT->size() && p->checkType((*argT)[pos])) {
+				search(p, pos + 1);
 			}
 		}
-		return nullptr;
 	}
-	const Function::FuncObject* Function::SignTreeMatch::match(const lightlist<TypeObject> &argT) {
-		const Node* currptr = ST.getRoot();
-		size_t index = 0;
-		for (auto &t : argT) {
-			currptr = checkSingle(currptr, t, index);
-			if (currptr == nullptr)
-				return nullptr;
-		}
-		if (index)
-			currptr = currptr->getChildren()[index - 1].get();
-		size_t callindex;
-		bool r = currptr->canEnd(callindex);
-		if (r)
-			return ST.getFunc(callindex);
-		else
-			return nullptr;
+	// The arguments from pos all match the repeated last parameter.
+	bool Function::SignTreeMatch::matchArgs(const Node *node, size_t pos) const {
+		for (size_t i : range(pos, argT->size()))
+			if (!node->checkType((*argT)[i]))
+				return false;
+		return true;
 	}
 
 	//=======================================
 	// * Functions
 	//=======================================
+	// Overloads are tried in order, the first match is taken.
+	// Set USE_SIGNTREE to false to scan them one by one.
+#ifndef USE_SIGNTREE
+#define USE_SIGNTREE true
+#endif
+	static size_t linearCallID(const FuncTableUnit &ftu, const lightlist<TypeObject> &typelist)
+	{
+		for (size_t i : Range<size_t>(0, ftu.size()))
+			if (ftu[i].checkType(typelist))
+				return i;
+		return ftu.size();
+	}
+	static size_t treeCallID(const FuncTableUnit &ftu, const lightlist<TypeObject> &typelist)
+	{
+		const Function::FuncObject *p = ftu.checkType(typelist);
+		return p ? p - &ftu[0] : ftu.size();
+	}
+	static size_t findCallID(const FuncTableUnit &ftu, const lightlist<TypeObject> &typelist)
+	{
+#if USE_SIGNTREE
+		return treeCallID(ftu, typelist);
+#else
+		return linearCallID(ftu, typelist);
+#endif
+	}
 	// Get Call ID
 	size_t getCallID(const FuncTableUnit &ftu, const DataList &dl)
 	{
-		size_t id = ftu.size();
-		const lightlist<TypeObject> &typelist = Function::getTypeObjectList(dl);
-		for (size_t i : Range<size_t>(0, ftu.size())) {
-			if (ftu[i].checkType(typelist)) {
-				id = i;
-				break;
-			}
-		}
-		return id;
+		return findCallID(ftu, Function::getTypeObjectList(dl));
 	}
 	// Check Call
 	ObjectPtr checkCall(const FuncTableUnit &ftu, const DataList &dl)
 	{
-		const lightlist<TypeObject> &typelist = Function::getTypeObjectList(dl);
-#define USE_SIGNTREE false
-#if USE_SIGNTREE
-		const Function::FuncObject *p = ftu.checkType(typelist);
-#else
-		size_t id = ftu.size();
-		for (size_t i : Range<size_t>(0, ftu.size())) {
-			if (ftu[i].checkType(typelist)) {
-				id = i;
-				break;
-			}
-		}
-#endif
+		size_t id = findCallID(ftu, Function::getTypeObjectList(dl));
 		CheckCallCount++;
-#if USE_SIGNTREE
-		if (p != nullptr) {
-			return p->call(dl);
-		}
-#else
 		if (id != ftu.size()) {
 			return ftu[id].call(dl);
 		}
-#endif
 		else {
 			std::string errinfo = "Matching Types in function '" + ftu.getName() + "'.";
 			return createError(errinfo);
 		}
 	}
+
+	bool checkCallL(const FuncTableUnit &ftu, const DataList &dl, Object* &slot, ObjectPtr &op)
+	{
+		size_t id = findCallID(ftu, Function::getTypeObjectList(dl));
+		CheckCallCount++;
+		if (id != ftu.size()) {
+			if (ftu[id].callL(slot, dl))
+				return true;
+			op = ftu[id].call(dl);
+		}
+		else {
+			op = createError("Matching Types in function '" + ftu.getName() + "'.");
+		}
+		return false;
+	}
+
+	// Benchmark
+	void benchDispatch()
+	{
+		using Clock = std::chrono::steady_clock;
+		const size_t Count = 100000;
+		// Keep the loops from being optimized away.
+		volatile size_t sink = 0;
+		for (const auto &var : GlobalFunctionTable) {
+			const FuncTableUnit &ftu = GlobalFunctionTable[var.second];
+			if (ftu.size() < 4)
+				continue;
+			Clock::duration linear{}, tree{};
+			bool same = true;
+			for (size_t i : range(0, ftu.size())) {
+				// The parameter types of overload i, with the repeated one twice.
+				const Function::Signature &sign = ftu[i].getSign();
+				const auto &in = sign.getInType();
+				bool args = sign.isLastArgs() && in.size() != 0;
+				lightlist_creater<TypeObject> llc(in.size() + args);
+				for (const TypeObject &t : in)
+					llc.push_back(t);
+				if (args)
+					llc.push_back(in[in.size() - 1]);
+				const lightlist<TypeObject> &typelist = llc.data();
+
+				same = same && linearCallID(ftu, typelist) == treeCallID(ftu, typelist);
+				auto t0 = Clock::now();
+				for (size_t n = 0; n != Count; ++n)
+					sink += linearCallID(ftu, typelist);
+				auto t1 = Clock::now();
+				for (size_t n = 0; n != Count; ++n)
+					sink += treeCallID(ftu, typelist);
+				auto t2 = Clock::now();
+				linear += t1 - t0;
+				tree += t2 - t1;
+			}
+			double calls = (double)(Count * ftu.size());
+			println(var.first, " (", ftu.size(), " overloads) : linear ",
+				std::chrono::duration<double, std::nano>(linear).count() / calls, " ns, tree ",
+				std::chrono::duration<double, std::nano>(tree).count() / calls, " ns",
+				same ? "" : " (MISMATCH)");
+		}
+	}
 }
@@ -0,0 +1,97 @@
+#include "basic.h"
+#include "runtime/native.h"
+#include "runtime/objectdef.h"
+#include "runtime/identtable.h"
+#include "parser/literal.h"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace ICM
+{
+	namespace NativeModule
+	{
+		//=======================================
+		// * Library
+		//=======================================
+#if defined(_WIN32)
+		using Handle = HMODULE;
+		static Handle open(const string &path) {
+			return LoadLibraryA(path.c_str());
+		}
+		static void* symbol(Handle handle, const char *name) {
+			return (void*)GetProcAddress(handle, name);
+		}
+		static void close(Handle handle) {
+			FreeLibrary(handle);
+		}
+		static string lastError() {
+			return "error " + std::to_string(GetLastError());
+		}
+#else
+		using Handle = void*;
+		static Handle open(const string &path) {
+			return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+		}
+		static void* symbol(Handle handle, const char *name) {
+			return dlsym(handle, name);
+		}
+		static void close(Handle handle) {
+			dlclose(handle);
+		}
+		static string lastError() {
+			const char *err = dlerror();
+			return err ? err : "unknown error";
+		}
+#endif
+
+		// Name the function id in the global IdentTable, as createIdentTable does.
+		static void nameFunction(const string &name, size_t id) {
+			IdentKey key = Compiler::GlobalIdentNameMap[name];
+			IdentBasicIndex index = findFromIdentTable(0, key);
+			if (index == getIdentTableSize(0)) {
+				index = insertFromIdentTable(0, key, I_StFunc);
+				getFromIdentTable(IdentIndex(0, index)).FunctionIndex = id;
+				return;
+			}
+			IdentTableUnit &itu = getFromIdentTable(IdentIndex(0, index));
+			if (itu.type == I_StFunc)
+				itu.FunctionIndex = id;
+			else if (itu.type == I_DyVarb)
+				itu.DyVarb = new Objects::Function(id);
+		}
+
+		string load(const string &path) {
+			static map<string, Handle> Loaded;
+			if (Loaded.find(path) != Loaded.end())
+				return string();
+
+			Handle handle = open(path);
+			if (!handle)
+				return "Cannot load '" + path + "' (" + lastError() + ").";
+			auto *version = (VersionFunc*)symbol(handle, "icm_native_version");
+			auto *module = (ModuleFunc*)symbol(handle, "icm_native_module");
+			if (!version || !module) {
+				close(handle);
+				return "'" + path + "' is not a native module.";
+			}
+			if (version() != Version) {
+				close(handle);
+				return "'" + path + "' is built for another version of the runtime.";
+			}
+
+			map<string, size_t> before(GlobalFunctionTable.begin(), GlobalFunctionTable.end());
+			module(GlobalFunctionTable);
+			for (const auto &var : GlobalFunctionTable) {
+				auto iter = before.find(var.first);
+				if (iter == before.end() || iter->second != var.second)
+					nameFunction(var.first, var.second);
+			}
+			// The functions live in the library, so it is kept open.
+			Loaded[path] = handle;
+			return string();
+		}
+	}
+}
@@ -0,0 +1,341 @@
+#include "basic.h"
+#include "runtime/number.h"
+#include "runtime/bigint.h"
+#include "runtime/hashtable.h"
+#include <cmath>
+#include <limits>
+
+namespace ICM
+{
+	static int ctz(uint64_t x) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(x);
+#else
+		int n = 0;
+		while ((x & 1) == 0) {
+			x >>= 1;
+			++n;
+		}
+		return n;
+#endif
+	}
+	static uint64_t uabs(int64_t x) {
+		return x < 0 ? 0 - (uint64_t)x : (uint64_t)x;
+	}
+
+	uint64_t gcd(uint64_t a, uint64_t b) {
+		if (a == 0)
+			return b;
+		if (b == 0)
+			return a;
+		int shift = ctz(a | b);
+		a >>= ctz(a);
+		do {
+			b >>= ctz(b);
+			if (a > b)
+				std::swap(a, b);
+			b -= a;
+		} while (b != 0);
+		return a << shift;
+	}
+
+	//=======================================
+	// * Class Rational
+	//=======================================
+	struct BigRational
+	{
+		BigInt n, d;
+	};
+
+	Rational Rational::fromBig(BigInt num, BigInt den) {
+		if (den.isNegative()) {
+			num = -num;
+			den = -den;
+		}
+		BigInt g = gcd(num, den);
+		if (g != BigInt(1)) {
+			num = num / g;
+			den = den / g;
+		}
+		Rational r;
+		if (num.fitsInt64() && den.fitsInt64()) {
+			r.n = num.toInt64();
+			r.d = den.toInt64();
+			return r;
+		}
+		r.n = 0;
+		r.d = -1;
+		r.big = std::make_shared<const BigRational>(BigRational{ std::move(num), std::move(den) });
+		return r;
+	}
+	BigRational Rational::toBig(const Rational &r) {
+		if (r.d == -1)
+			return *r.big;
+		return BigRational{ BigInt(r.n), BigInt(r.d) };
+	}
+	bool Rational::equalBig(const Rational &a, const Rational &b) {
+		return a.big->n == b.big->n && a.big->d == b.big->d;
+	}
+	Rational Rational::negate(const Rational &r) {
+		if (r.d == 0)
+			return r;
+		if (r.d == -1 || r.n == INT64_MIN) {
+			BigRational b = toBig(r);
+			return fromBig(-b.n, b.d);
+		}
+		Rational t = r;
+		t.n = -r.n;
+		return t;
+	}
+
+	Rational::Rational(int64_t num, int64_t den) {
+		if (den == 0) {
+			*this = NaN();
+			return;
+		}
+		uint64_t g = gcd(uabs(num), uabs(den));
+		uint64_t un = uabs(num) / g;
+		uint64_t ud = uabs(den) / g;
+		bool neg = (num < 0) != (den < 0);
+		if (ud > (uint64_t)INT64_MAX || un > (uint64_t)INT64_MAX + neg) {
+			*this = fromBig(BigInt(num), BigInt(den));
+			return;
+		}
+		n = neg ? (int64_t)(0 - un) : (int64_t)un;
+		d = (int64_t)ud;
+	}
+
+	bool Rational::parse(const char *str, Rational &r) {
+		const char *p = str;
+		bool neg = *p == '-';
+		if (neg)
+			++p;
+		if (!isdigit(*p))
+			return false;
+		int64_t num = 0, den = 1;
+		bool overflow = false;
+		// Accumulate negative numbers downward, so that INT64_MIN is reachable.
+		auto digits = [&](int64_t &v, bool negative) {
+			const char *begin = p;
+			for (; isdigit(*p); ++p) {
+				int64_t c = *p - '0';
+				overflow |= Checked::mul(v, 10, v);
+				overflow |= negative ? Checked::sub(v, c, v) : Checked::add(v, c, v);
+			}
+			return std::make_pair(begin, p);
+		};
+		auto sn = digits(num, neg), sd = sn;
+		if (*p == '/') {
+			++p;
+			if (!isdigit(*p))
+				return false;
+			den = 0;
+			sd = digits(den, false);
+		}
+		if (*p != '\0')
+			return false;
+		if (!overflow) {
+			r = Rational(num, den);
+			return true;
+		}
+		// Redo it with big integers.
+		BigInt bn = BigInt::parse(sn.first, sn.second);
+		BigInt bd = sd == sn ? BigInt(1) : BigInt::parse(sd.first, sd.second);
+		if (neg)
+			bn = -bn;
+		r = bd.isZero() ? NaN() : fromBig(bn, bd);
+		return true;
+	}
+
+	Rational Rational::from_double(double v) {
+		if (!std::isfinite(v))
+			return NaN();
+		// v = m * 2^e, with an integral m of 53 bits.
+		int e;
+		double m = std::frexp(v, &e);
+		Rational r((int64_t)std::ldexp(m, 53));
+		e -= 53;
+		Rational p(1);
+		for (int i = 0; i < std::abs(e); ++i)
+			p *= 2;
+		return e < 0 ? r / p : r * p;
+	}
+
+	int64_t Rational::to_int64() const {
+		if (d == 0)
+			return 0;
+		if (d == -1)
+			return (big->n / big->d).toInt64();
+		return n / d;
+	}
+	double Rational::to_double() const {
+		if (d == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		if (d == -1)
+			return big->n.to_double() / big->d.to_double();
+		return d == 1 ? (double)n : (double)n / (double)d;
+	}
+
+	Rational Rational::floor() const {
+		if (d == 1 || d == 0)
+			return *this;
+		if (d == -1)
+			return fromBig(BigInt::floordiv(big->n, big->d), BigInt(1));
+		return Rational(n / d - (n % d < 0 ? 1 : 0));
+	}
+	Rational Rational::trunc() const {
+		if (d == 1 || d == 0)
+			return *this;
+		if (d == -1)
+			return fromBig(big->n / big->d, BigInt(1));
+		return Rational(n / d);
+	}
+
+	size_t Rational::hash() const {
+		if (d == -1)
+			return Container::hash_combine(big->n.hash(), big->d.hash());
+		size_t h = Container::hash_mix((uint64_t)n);
+		return d == 1 ? h : Container::hash_combine(h, Container::hash_mix((uint64_t)d));
+	}
+
+	// Knuth, TAOCP 4.5.1
+	Rational Rational::add(const Rational &a, const Rational &b) {
+		if (a.d == 0 || b.d == 0)
+			return NaN();
+		if (a.d == -1 || b.d == -1) {
+			BigRational x = toBig(a), y = toBig(b);
+			return fromBig(x.n * y.d + y.n * x.d, x.d * y.d);
+		}
+		int64_t g = (int64_t)gcd((uint64_t)a.d, (uint64_t)b.d);
+		Rational r;
+		if (g == 1) {
+			int64_t x, y;
+			if (Checked::mul(a.n, b.d, x) || Checked::mul(b.n, a.d, y) || Checked::add(x, y, r.n) || Checked::mul(a.d, b.d, r.d))
+				return fromBig(BigInt(a.n) * BigInt(b.d) + BigInt(b.n) * BigInt(a.d), BigInt(a.d) * BigInt(b.d));
+			return r;
+		}
+		int64_t s = a.d / g, x, y, t;
+		if (Checked::mul(a.n, b.d / g, x) || Checked::mul(b.n, s, y) || Checked::add(x, y, t))
+			return fromBig(BigInt(a.n) * BigInt(b.d) + BigInt(b.n) * BigInt(a.d), BigInt(a.d) * BigInt(b.d));
+		int64_t g2 = (int64_t)gcd(uabs(t), (uint64_t)g);
+		r.n = t / g2;
+		if (Checked::mul(s, b.d / g2, r.d))
+			return fromBig(BigInt(t / g2), BigInt(s) * BigInt(b.d / g2));
+		return r;
+	}
+	Rational Rational::sub(const Rational &a, const Rational &b) {
+		return add(a, negate(b));
+	}
+	Rational Rational::mul(const Rational &a, const Rational &b) {
+		if (a.d == 0 || b.d == 0)
+			return NaN();
+		if (a.d == -1 || b.d == -1) {
+			BigRational x = toBig(a), y = toBig(b);
+			return fromBig(x.n * y.n, x.d * y.d);
+		}
+		int64_t g1 = (int64_t)gcd(uabs(a.n), (uint64_t)b.d);
+		int64_t g2 = (int64_t)gcd(uabs(b.n), (uint64_t)a.d);
+		if (g1 == 0 || g2 == 0)
+			return Rational();
+		Rational r;
+		if (Checked::mul(a.n / g1, b.n / g2, r.n) || Checked::mul(a.d / g2, b.d / g1, r.d))
+			return fromBig(BigInt(a.n / g1) * BigInt(b.n / g2), BigInt(a.d / g2) * BigInt(b.d / g1));
+		return r;
+	}
+	Rational Rational::div(const Rational &a, const Rational &b) {
+		if (b.d == 0 || (b.d != -1 && b.n == 0))
+			return NaN();
+		if (b.d == -1 || b.n == INT64_MIN) {
+			BigRational y = toBig(b);
+			return mul(a, fromBig(y.d, y.n));
+		}
+		Rational inv;
+		inv.n = b.n < 0 ? -b.d : b.d;
+		inv.d = b.n < 0 ? -b.n : b.n;
+		return mul(a, inv);
+	}
+
+	// Compare the continued fractions, which needs no wider integers.
+	int Rational::compare(const Rational &a, const Rational &b) {
+		if (a.d == 0 || b.d == 0)
+			return 2;
+		if (a.d == -1 || b.d == -1) {
+			BigRational x = toBig(a), y = toBig(b);
+			return ICM::compare(x.n * y.d, y.n * x.d);
+		}
+		int64_t an = a.n, ad = a.d, bn = b.n, bd = b.d;
+		while (true) {
+			int64_t qa = an / ad, ra = an % ad;
+			int64_t qb = bn / bd, rb = bn % bd;
+			if (ra < 0) {
+				qa--;
+				ra += ad;
+			}
+			if (rb < 0) {
+				qb--;
+				rb += bd;
+			}
+			if (qa != qb)
+				return qa < qb ? -1 : 1;
+			if (ra == 0 || rb == 0)
+				return ra == rb ? 0 : ra == 0 ? -1 : 1;
+			// ra/ad < rb/bd <=> bd/rb < ad/ra
+			int64_t oldad = ad;
+			an = bd;
+			ad = rb;
+			bn = oldad;
+			bd = ra;
+		}
+	}
+
+	Rational mod(const Rational &a, const Rational &b) {
+		if (a.d == 1 && b.d == 1) {
+			if (b.n == 0)
+				return Rational::NaN();
+			if (b.n == -1)
+				return Rational();
+			int64_t r = a.n % b.n;
+			if (r != 0 && ((r < 0) != (b.n < 0)))
+				r += b.n;
+			return Rational(r);
+		}
+		return a - b * (a / b).floor();
+	}
+	Rational rem(const Rational &a, const Rational &b) {
+		if (a.d == 1 && b.d == 1) {
+			if (b.n == 0)
+				return Rational::NaN();
+			if (b.n == -1)
+				return Rational();
+			return Rational(a.n % b.n);
+		}
+		return a - b * (a / b).trunc();
+	}
+	Rational gcd(const Rational &a, const Rational &b) {
+		if (a.d == 0 || b.d == 0)
+			return Rational::NaN();
+		// gcd(a/b, c/d) = gcd(a, c) / lcm(b, d)
+		if (a.d != -1 && b.d != -1) {
+			uint64_t gn = gcd(uabs(a.n), uabs(b.n));
+			int64_t lcm;
+			if (gn <= (uint64_t)INT64_MAX && !Checked::mul(a.d / (int64_t)gcd((uint64_t)a.d, (uint64_t)b.d), b.d, lcm))
+				return Rational((int64_t)gn, lcm);
+		}
+		BigRational x = Rational::toBig(a), y = Rational::toBig(b);
+		return Rational::fromBig(gcd(x.n, y.n), x.d / gcd(x.d, y.d) * y.d);
+	}
+
+	string Rational::to_string() const {
+		if (d == 0)
+			return "NaN";
+		if (d == -1)
+			return big->d == BigInt(1) ? big->n.to_string() : big->n.to_string() + "/" + big->d.to_string();
+		if (d == 1)
+			return std::to_string(n);
+		return std::to_string(n) + "/" + std::to_string(d);
+	}
+
+	string to_string(const Rational &r) {
+		return r.to_string();
+	}
+}
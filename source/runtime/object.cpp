@@ -1,6 +1,8 @@
 #include "basic.h"
 #include "runtime/objectdef.h"
+#include "runtime/hashtable.h"
 #include "parser/keyword.h"
+#include <cstring>
 
 namespace ICM
 {
@@ -27,8 +29,18 @@ namespace ICM
 		DEFTYPENAME(Keyword);
 		DEFTYPENAME(Type);
 		// List Types
+		DEFTYPENAME(Array);
 		DEFTYPENAME(List);
 		DEFTYPENAME(Disperse);
+		DEFTYPENAME(PVector);
+		DEFTYPENAME(Slice);
+		DEFTYPENAME(Deque);
+		DEFTYPENAME(PQueue);
+		// Map Types
+		DEFTYPENAME(Map);
+		DEFTYPENAME(OrdMap);
+		// Struct Types
+		DEFTYPENAME(Struct);
 		// Compile Types (Platform Dependent)
 		DEFTYPENAME(Int);
 		DEFTYPENAME(UInt);
@@ -74,6 +86,10 @@ namespace ICM
 		return "nil";
 	}
 	template <>
+	string to_string<T_Double>(ConstDataPointer data) {
+		return TypeBase::to_string(*get<T_Double>((void*)data));
+	}
+	template <>
 	string to_string<T_Null>(ConstDataPointer data) {
 		return "Null";
 	}
@@ -97,6 +113,25 @@ namespace ICM
 	string to_output<T_Null>(ConstDataPointer data) {
 		return "Null";
 	}
+	// Fixed-width integers print as integers, even the char sized ones.
+#define FIXEDINT_TO_STRING(_TE) \
+	template <> string to_string<T_##_TE>(ConstDataPointer data) { return std::to_string(+*get<T_##_TE>((void*)data)); } \
+	template <> string to_output<T_##_TE>(ConstDataPointer data) { return to_string<T_##_TE>(data); }
+	FIXEDINT_TO_STRING(Int)
+	FIXEDINT_TO_STRING(UInt)
+	FIXEDINT_TO_STRING(Byte)
+	FIXEDINT_TO_STRING(Word)
+	FIXEDINT_TO_STRING(DWord)
+	FIXEDINT_TO_STRING(QWord)
+	FIXEDINT_TO_STRING(Int8)
+	FIXEDINT_TO_STRING(Int16)
+	FIXEDINT_TO_STRING(Int32)
+	FIXEDINT_TO_STRING(Int64)
+	FIXEDINT_TO_STRING(UInt8)
+	FIXEDINT_TO_STRING(UInt16)
+	FIXEDINT_TO_STRING(UInt32)
+	FIXEDINT_TO_STRING(UInt64)
+#undef FIXEDINT_TO_STRING
 	template <>
 	string to_string_code<T_Test>(ConstDataPointer data) {
 		return "Test";
@@ -115,6 +150,82 @@ namespace ICM
 		return *(Type*)dat1 == *(Type*)dat2;
 	}
 
+	// Only the types specialized here are hashable.
+	template <TypeUnit _TU>
+	struct HashFunc {
+		constexpr static TypeInfo::HasFunc *func = nullptr;
+	};
+	template <>
+	struct HashFunc<T_Boolean> {
+		static size_t func(ConstDataPointer data) {
+			return Container::hash_mix(*get<T_Boolean>((void*)data) ? 1 : 0);
+		}
+	};
+	template <>
+	struct HashFunc<T_Number> {
+		static size_t func(ConstDataPointer data) {
+			return get<T_Number>((void*)data)->hash();
+		}
+	};
+	template <>
+	struct HashFunc<T_Double> {
+		static size_t func(ConstDataPointer data) {
+			double d = *get<T_Double>((void*)data);
+			// -0.0 equals 0.0, so that it hashes alike.
+			if (d == 0)
+				d = 0;
+			uint64_t bits;
+			std::memcpy(&bits, &d, sizeof(bits));
+			return Container::hash_mix(bits);
+		}
+	};
+#define FIXEDINT_HASHFUNC(_TE) \
+	template <> struct HashFunc<T_##_TE> { \
+		static size_t func(ConstDataPointer data) { return Container::hash_mix((uint64_t)*get<T_##_TE>((void*)data)); } \
+	};
+	FIXEDINT_HASHFUNC(Int)
+	FIXEDINT_HASHFUNC(UInt)
+	FIXEDINT_HASHFUNC(Byte)
+	FIXEDINT_HASHFUNC(Word)
+	FIXEDINT_HASHFUNC(DWord)
+	FIXEDINT_HASHFUNC(QWord)
+	FIXEDINT_HASHFUNC(Int8)
+	FIXEDINT_HASHFUNC(Int16)
+	FIXEDINT_HASHFUNC(Int32)
+	FIXEDINT_HASHFUNC(Int64)
+	FIXEDINT_HASHFUNC(UInt8)
+	FIXEDINT_HASHFUNC(UInt16)
+	FIXEDINT_HASHFUNC(UInt32)
+	FIXEDINT_HASHFUNC(UInt64)
+#undef FIXEDINT_HASHFUNC
+	template <>
+	struct HashFunc<T_String> {
+		static size_t func(ConstDataPointer data) {
+			const char *str = get<T_String>((void*)data)->c_str();
+			return Container::hash_bytes(str, std::strlen(str));
+		}
+	};
+	template <>
+	struct HashFunc<T_Symbol> {
+		static size_t func(ConstDataPointer data) {
+			const string &str = *get<T_Symbol>((void*)data);
+			return Container::hash_bytes(str.data(), str.size());
+		}
+	};
+	template <>
+	struct HashFunc<T_List> {
+		static size_t func(ConstDataPointer data) {
+			const auto &list = get<T_List>((void*)data)->getData();
+			size_t seed = Container::hash_mix(list.size());
+			for (const Object *op : list) {
+				// Unhashable elements only contribute their type.
+				size_t h = op->hashable() ? op->hash() : Container::hash_mix(op->type);
+				seed = Container::hash_combine(seed, h);
+			}
+			return seed;
+		}
+	};
+
 	//=======================================
 	//=======================================
 #define TEMPFUNC template <TypeUnit _TU> inline
@@ -144,6 +255,7 @@ namespace ICM
 			destruct<_TU>,
 			ncopy<_TU>,
 			equal<_TU>,
+			HashFunc<_TU>::func,
 			to_string<_TU>,
 			to_output<_TU>,
 			to_string_code<_TU>
@@ -168,9 +280,18 @@ namespace ICM
 		TypeInfoPair<T_Function>(),
 		TypeInfoPair<T_Type>(),
 		// List Types
-		//TypeInfoPair<T_Array>(),
+		TypeInfoPair<T_Array>(),
 		TypeInfoPair<T_List>(),
 		TypeInfoPair<T_Disperse>(),
+		TypeInfoPair<T_PVector>(),
+		TypeInfoPair<T_Slice>(),
+		TypeInfoPair<T_Deque>(),
+		TypeInfoPair<T_PQueue>(),
+		// Map Types
+		TypeInfoPair<T_Map>(),
+		TypeInfoPair<T_OrdMap>(),
+		// Struct Types
+		TypeInfoPair<T_Struct>(),
 		// Compile Types (Platform Dependent)
 		TypeInfoPair<T_Int>(),
 		TypeInfoPair<T_UInt>(),
@@ -205,8 +326,10 @@ namespace ICM
 		case ICM::T_Nil:        return new Nil;
 		case ICM::T_Error:      return new Error;
 		case ICM::T_Keyword:    return new Objects::Keyword;
+		case ICM::T_Array:      return new Objects::Array;
 		case ICM::T_List:       return new List;
 		case ICM::T_Disperse:   return nullptr; // TODO
+		case ICM::T_Map:        return new Objects::Map;
 		case ICM::T_Number:     return new Objects::Number;
 		case ICM::T_String:     return new String;
 		case ICM::T_Char:       return nullptr; // TODO
@@ -226,11 +349,11 @@ namespace ICM
 	namespace Objects
 	{
 		// Get Disperse Iterator
-		vector<Object*>::iterator begin(Objects::Disperse *disp)
+		TypeBase::DisperseType::const_iterator begin(Objects::Disperse *disp)
 		{
 			return disp->get<T_Disperse>()->begin();
 		}
-		vector<Object*>::iterator end(Objects::Disperse *disp)
+		TypeBase::DisperseType::const_iterator end(Objects::Disperse *disp)
 		{
 			return disp->get<T_Disperse>()->end();
 		}
@@ -240,5 +363,5 @@ namespace ICM
 
 	const bool StaticObject::Value_True = true;
 	const bool StaticObject::Value_False = false;
-	const uint64_t StaticObject::Value_Zero = 0;
+	const Rational StaticObject::Value_Zero = 0;
 }
@@ -0,0 +1,17 @@
+#include "basic.h"
+#include "runtime/random.h"
+#include <chrono>
+
+namespace ICM
+{
+	void RandomEngine::seed(uint64_t seed) {
+		for (auto &x : s) {
+			uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			x = z ^ (z >> 31);
+		}
+	}
+
+	RandomEngine GlobalRandom((uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+}
@@ -0,0 +1,61 @@
+#include "basic.h"
+#include "runtime/sortengine.h"
+#include <thread>
+
+namespace ICM
+{
+	namespace SortEngine
+	{
+		size_t chunks(size_t n) {
+			static const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+			size_t count = 1;
+			while (count * 2 <= threads && n / (count * 2) >= ChunkMin)
+				count *= 2;
+			return count;
+		}
+
+		void parallel(size_t count, const std::function<void(size_t)> &task) {
+			vector<std::thread> workers;
+			workers.reserve(count - 1);
+			for (size_t i : range(1, count))
+				workers.emplace_back(task, i);
+			task(0);
+			for (auto &worker : workers)
+				worker.join();
+		}
+
+		void radix(Keyed *data, size_t n) {
+			auto less = [](const Keyed &a, const Keyed &b) { return a.key < b.key; };
+			if (n < RadixMin) {
+				std::stable_sort(data, data + n, less);
+				return;
+			}
+
+			// The counts of each byte of the keys, found in one pass.
+			vector<size_t> counts(8 * 256);
+			for (size_t i : range(0, n))
+				for (size_t b : range(0, 8))
+					counts[b * 256 + ((data[i].key >> (b * 8)) & 0xFF)]++;
+
+			vector<Keyed> buffer(n);
+			Keyed *from = data, *to = buffer.data();
+			size_t offsets[256];
+			for (size_t b : range(0, 8)) {
+				const size_t *count = &counts[b * 256];
+				// The byte is the same in all the keys.
+				if (count[(from[0].key >> (b * 8)) & 0xFF] == n)
+					continue;
+				size_t sum = 0;
+				for (size_t d : range(0, 256)) {
+					offsets[d] = sum;
+					sum += count[d];
+				}
+				for (size_t i : range(0, n))
+					to[offsets[(from[i].key >> (b * 8)) & 0xFF]++] = from[i];
+				std::swap(from, to);
+			}
+			if (from != data)
+				std::copy(from, from + n, data);
+		}
+	}
+}
@@ -1,6 +1,11 @@
 #include "basic.h"
 #include "runtime/typebase.h"
 #include "runtime/objectdef.h"
+#include "runtime/fixedint.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 
 namespace ICM
 {
@@ -21,26 +26,435 @@ namespace ICM
 			data.insert(data.end(), dl.data.begin(), dl.data.end());
 			return *this;
 		}
+		bool ListType::operator==(const ListType &lt) const {
+			if (data.size() != lt.data.size())
+				return false;
+			for (size_t i : range(0, data.size()))
+				if (!data[i]->equ(lt.data[i]))
+					return false;
+			return true;
+		}
 		string ListType::to_string() const {
-			return ICM::to_string(data);
+			return Common::Convert::to_string<'[', ']'>(data.begin(), data.end(), [](const Object *op) { return op->to_string(); });
 		}
 		string ListType::to_output() const {
 			return Common::Convert::to_string<'[', ']'>(data.begin(), data.end(), [](const ObjectPtr &op) { return op.to_output(); });
 		}
 
+		//=======================================
+		// * Class Slice
+		//=======================================
+		ListType SliceType::to_list() const {
+			ListType lt;
+			lt.reserve(length);
+			for (size_t i : range(0, length))
+				lt.push(at(i));
+			return lt;
+		}
+		bool SliceType::operator==(const SliceType &st) const {
+			if (length != st.length)
+				return false;
+			for (size_t i : range(0, length))
+				if (!at(i)->equ(st.at(i)))
+					return false;
+			return true;
+		}
+		string SliceType::to_string() const {
+			return to_list().to_string();
+		}
+		string SliceType::to_output() const {
+			return to_list().to_output();
+		}
+
+		//=======================================
+		// * Double
+		//=======================================
+		template <> string to_string<double>(const double &v) {
+			if (std::isnan(v))
+				return "nan";
+			if (std::isinf(v))
+				return v < 0 ? "-inf" : "inf";
+			char buf[40];
+			int prec = 1;
+			for (; prec < 17; ++prec) {
+				std::snprintf(buf, sizeof(buf), "%.*e", prec - 1, v);
+				if (std::strtod(buf, nullptr) == v)
+					break;
+			}
+			std::snprintf(buf, sizeof(buf), "%.*e", prec - 1, v);
+			int exp = std::atoi(std::strchr(buf, 'e') + 1);
+			// Keep a point, so that it reads back as a Double.
+			if (exp >= -5 && exp < 17)
+				std::snprintf(buf, sizeof(buf), "%.*f", std::max(prec - 1 - exp, 1), v);
+			return buf;
+		}
+
+		//=======================================
+		// * Class Array
+		//=======================================
+		template <typename T>
+		static string elem_to_string(T v) {
+			return std::to_string(v);
+		}
+		static string elem_to_string(double v) {
+			return to_string<double>(v);
+		}
+		static string elem_to_string(float v) {
+			return elem_to_string((double)v);
+		}
+		bool ArrayType::isElemType(TypeUnit type) {
+			return elemSize(type) != 0;
+		}
+		size_t ArrayType::elemSize(TypeUnit type) {
+			switch (type) {
+			case T_Int:    return sizeof(int_t);
+			case T_UInt:   return sizeof(uint_t);
+			case T_Float:  return sizeof(float);
+			case T_Double: return sizeof(double);
+			case T_Byte:
+			case T_Int8:
+			case T_UInt8:  return 1;
+			case T_Word:
+			case T_Int16:
+			case T_UInt16: return 2;
+			case T_DWord:
+			case T_Int32:
+			case T_UInt32: return 4;
+			case T_QWord:
+			case T_Int64:
+			case T_UInt64: return 8;
+			default:       return 0;
+			}
+		}
+		// Integer elements are boxed in their own fixed-width type.
+		Object* ArrayType::get(size_t index) const {
+			Object *result = nullptr;
+			visit([&](auto *p) {
+				if (isFloatType(elemtype))
+					result = new Objects::Double((double)p[index]);
+				else
+					result = FixedInt::box(elemtype, (uint64_t)p[index]);
+			});
+			return result;
+		}
+		// Truncate v to T. Return false if it is NaN, or out of the range of T.
+		template <typename T>
+		static bool fromDouble(double v, T &r) {
+			if (!std::is_floating_point<T>::value) {
+				const double t = std::trunc(v);
+				const double limit = std::ldexp(1.0, std::numeric_limits<T>::digits);
+				if (!(t >= (std::is_signed<T>::value ? -limit : 0) && t < limit))
+					return false;
+			}
+			r = (T)v;
+			return true;
+		}
+		bool ArrayType::set(size_t index, const Object *op) {
+			bool ok = true;
+			visit([&](auto *p) {
+				using T = std::remove_pointer_t<decltype(p)>;
+				if (op->type == T_Number)
+					p[index] = (T)op->dat<T_Number>();
+				else if (op->type == T_Double)
+					ok = fromDouble(op->dat<T_Double>(), p[index]);
+				else if (FixedInt::isSigned(op->type))
+					p[index] = (T)(int64_t)FixedInt::load(op);
+				else if (FixedInt::isFixedInt(op->type))
+					p[index] = (T)FixedInt::load(op);
+				else
+					ok = false;
+			});
+			return ok;
+		}
+		bool ArrayType::push(const Object *op) {
+			if (op->type != T_Number && op->type != T_Double && !FixedInt::isFixedInt(op->type))
+				return false;
+			resize(length + 1);
+			if (set(length - 1, op))
+				return true;
+			resize(length - 1);
+			return false;
+		}
+		void ArrayType::sort() {
+			visit([&](auto *p) { std::sort(p, p + length); });
+		}
+		bool ArrayType::operator==(const ArrayType &at) const {
+			if (elemtype != at.elemtype || length != at.length)
+				return false;
+			return std::memcmp(buffer.data(), at.buffer.data(), length * esize) == 0;
+		}
+		string ArrayType::to_string() const {
+			string str(TypeInfoTable.at(elemtype).name);
+			visit([&](auto *p) {
+				str.append(Convert::to_string<'[', ']'>(p, p + length, [](auto v) {
+					return elem_to_string(v);
+				}));
+			});
+			return str;
+		}
+		string ArrayType::to_output() const {
+			return to_string();
+		}
+
 		//=======================================
 		// * Class Disperse
 		//=======================================
 		string DisperseType::to_string() const {
-			return Convert::to_string(data.begin(), data.end(), [](const ObjectPtr &op) { return ICM::to_string(op); });
+			return Convert::to_string(begin(), end(), [](const ObjectPtr &op) { return ICM::to_string(op); });
 		}
 		string DisperseType::to_output() const {
 			string str;
-			for (auto &op : data)
+			for (Object *op : *this)
 				str.append(op->to_output());
 			return str;
 		}
 
+		//=======================================
+		// * Class PVector
+		//=======================================
+		ListType PVectorType::to_list() const {
+			ListType lt;
+			lt.reserve(size());
+			data.for_each([&](Object *op) { lt.push(op); });
+			return lt;
+		}
+		bool PVectorType::operator==(const PVectorType &pv) const {
+			if (size() != pv.size())
+				return false;
+			for (size_t i : range(0, size()))
+				if (!at(i)->equ(pv.at(i)))
+					return false;
+			return true;
+		}
+		string PVectorType::to_string() const {
+			return "#" + to_list().to_string();
+		}
+		string PVectorType::to_output() const {
+			return "#" + to_list().to_output();
+		}
+
+		//=======================================
+		// * Class Deque
+		//=======================================
+		DequeType::DequeType(const ListType &lt) {
+			data.reserve(lt.size());
+			for (Object *op : lt.getData())
+				data.push_back(op);
+		}
+		ListType DequeType::to_list() const {
+			ListType lt;
+			lt.reserve(size());
+			for (size_t i : range(0, size()))
+				lt.push(at(i));
+			return lt;
+		}
+		bool DequeType::operator==(const DequeType &dt) const {
+			if (size() != dt.size())
+				return false;
+			for (size_t i : range(0, size()))
+				if (!at(i)->equ(dt.at(i)))
+					return false;
+			return true;
+		}
+		string DequeType::to_string() const {
+			return "Deque" + to_list().to_string();
+		}
+		string DequeType::to_output() const {
+			return "Deque" + to_list().to_output();
+		}
+
+		//=======================================
+		// * Class PQueue
+		//=======================================
+		bool PQueueType::operator==(const PQueueType &pq) const {
+			const auto &d1 = data.getData();
+			const auto &d2 = pq.data.getData();
+			if (d1.size() != d2.size())
+				return false;
+			for (size_t i : range(0, d1.size()))
+				if (d1[i].rank != d2[i].rank || d1[i].key != d2[i].key || !d1[i].value->equ(d2[i].value))
+					return false;
+			return true;
+		}
+		// In the order they would be popped.
+		ListType PQueueType::to_list() const {
+			Data heap = data;
+			ListType lt;
+			lt.reserve(size());
+			while (!heap.empty())
+				lt.push(heap.pop().value);
+			return lt;
+		}
+		string PQueueType::to_string() const {
+			return "PQueue" + to_list().to_string();
+		}
+		string PQueueType::to_output() const {
+			return "PQueue" + to_list().to_output();
+		}
+
+		//=======================================
+		// * Class Map
+		//=======================================
+		void MapType::insert(Object *key, Object *value) {
+			Object **p = data.find(key);
+			if (p)
+				*p = value;
+			else
+				// Copy the key, so that changing the origin will not break the table.
+				data.insert(key->clone(), value);
+		}
+		bool MapType::operator==(const MapType &mt) const {
+			if (size() != mt.size())
+				return false;
+			for (const auto &e : data) {
+				Object *value = mt.find(e.first);
+				if (value == nullptr || !value->equ(e.second))
+					return false;
+			}
+			return true;
+		}
+		string MapType::to_string() const {
+			return Convert::to_string<'{', '}'>(data.begin(), data.end(), [](const Table::Entry &e) {
+				return e.first->to_string() + ":" + e.second->to_string();
+			});
+		}
+		string MapType::to_output() const {
+			return Convert::to_string<'{', '}'>(data.begin(), data.end(), [](const Table::Entry &e) {
+				return e.first->to_output() + ":" + e.second->to_output();
+			});
+		}
+
+		//=======================================
+		// * Class OrdMap
+		//=======================================
+		bool OrdMapType::isKey(const Object *op) {
+			switch (op->type) {
+			case T_Number:
+				return !op->dat<T_Number>().isNaN();
+			case T_String:
+			case T_Symbol:
+				return true;
+			default:
+				return false;
+			}
+		}
+		int OrdMapType::compareKey(const Object *a, const Object *b) {
+			if (a->type != b->type)
+				return a->type == T_Number || (a->type == T_String && b->type == T_Symbol) ? -1 : 1;
+			switch (a->type) {
+			case T_Number: {
+				const NumberType &x = a->dat<T_Number>(), &y = b->dat<T_Number>();
+				return x < y ? -1 : y < x;
+			}
+			case T_String: {
+				int c = std::strcmp(a->dat<T_String>().c_str(), b->dat<T_String>().c_str());
+				return c < 0 ? -1 : c > 0;
+			}
+			default: {
+				int c = a->dat<T_Symbol>().compare(b->dat<T_Symbol>());
+				return c < 0 ? -1 : c > 0;
+			}
+			}
+		}
+		bool OrdMapType::assign_sorted(const vector<std::pair<Object*, Object*>> &entries) {
+			for (size_t i : range(1, entries.size()))
+				if (compareKey(entries[i - 1].first, entries[i].first) >= 0)
+					return false;
+			vector<std::pair<Object*, Object*>> copy(entries);
+			for (auto &e : copy)
+				e.first = e.first->clone();
+			data = Tree::from_sorted(copy.begin(), copy.end());
+			return true;
+		}
+		void OrdMapType::insert(Object *key, Object *value) {
+			Object **p = data.find(key);
+			if (p)
+				*p = value;
+			else
+				// Copy the key, so that changing the origin will not break the order.
+				data.insert(key->clone(), value);
+		}
+		bool OrdMapType::operator==(const OrdMapType &mt) const {
+			if (size() != mt.size())
+				return false;
+			for (auto i = begin(), j = mt.begin(); i != end(); ++i, ++j)
+				if (compareKey(i.key(), j.key()) != 0 || !i.value()->equ(j.value()))
+					return false;
+			return true;
+		}
+		string OrdMapType::to_string() const {
+			string str = "OrdMap{";
+			for (auto it = begin(); it != end(); ++it)
+				str += (it == begin() ? "" : " ") + it.key()->to_string() + ":" + it.value()->to_string();
+			return str + "}";
+		}
+		string OrdMapType::to_output() const {
+			string str = "OrdMap{";
+			for (auto it = begin(); it != end(); ++it)
+				str += (it == begin() ? "" : " ") + it.key()->to_output() + ":" + it.value()->to_output();
+			return str + "}";
+		}
+
+		//=======================================
+		// * Class Struct
+		//=======================================
+		vector<StructInfo> GlobalStructTable;
+
+		StructType::Header* StructType::allocate(size_t id, size_t size) {
+			Header *p = static_cast<Header*>(::operator new(sizeof(Header) + size * sizeof(Object*)));
+			p->id = id;
+			p->size = size;
+			return p;
+		}
+		StructType::StructType(size_t id) {
+			size_t size = GlobalStructTable[id].fields.size();
+			block = allocate(id, size);
+			std::fill_n(slots(), size, &Static.Nil);
+		}
+		StructType::StructType(const StructType &st) {
+			if (st.block) {
+				block = allocate(st.block->id, st.block->size);
+				std::copy_n(st.slots(), st.block->size, slots());
+			}
+		}
+		const StructInfo& StructType::getInfo() const {
+			return GlobalStructTable[getID()];
+		}
+		bool StructType::operator==(const StructType &st) const {
+			if (block == nullptr || st.block == nullptr)
+				return block == st.block;
+			if (getID() != st.getID())
+				return false;
+			for (size_t i : range(0, size()))
+				if (!get(i)->equ(st.get(i)))
+					return false;
+			return true;
+		}
+		string StructType::to_string() const {
+			if (block == nullptr)
+				return "Struct{}";
+			const StructInfo &info = getInfo();
+			string str = info.name + "{";
+			for (size_t i : range(0, size())) {
+				if (i != 0)
+					str.push_back(' ');
+				str.append(info.fields[i] + ":" + get(i)->to_string());
+			}
+			return str + "}";
+		}
+		string StructType::to_output() const {
+			if (block == nullptr)
+				return "Struct{}";
+			const StructInfo &info = getInfo();
+			string str = info.name + "{";
+			for (size_t i : range(0, size())) {
+				if (i != 0)
+					str.push_back(' ');
+				str.append(info.fields[i] + ":" + get(i)->to_output());
+			}
+			return str + "}";
+		}
+
 		template<> string to_string<TypeType>(const TypeType &tt) {
 			return tt.to_string();
 		}
@@ -50,6 +464,30 @@ namespace ICM
 		template <> string to_string<DisperseType>(const DisperseType &lt) {
 			return lt.to_string();
 		}
+		template <> string to_string<ArrayType>(const ArrayType &at) {
+			return at.to_string();
+		}
+		template <> string to_string<SliceType>(const SliceType &st) {
+			return st.to_string();
+		}
+		template <> string to_string<DequeType>(const DequeType &dt) {
+			return dt.to_string();
+		}
+		template <> string to_string<PQueueType>(const PQueueType &pq) {
+			return pq.to_string();
+		}
+		template <> string to_string<PVectorType>(const PVectorType &pv) {
+			return pv.to_string();
+		}
+		template <> string to_string<MapType>(const MapType &mt) {
+			return mt.to_string();
+		}
+		template <> string to_string<OrdMapType>(const OrdMapType &mt) {
+			return mt.to_string();
+		}
+		template <> string to_string<StructType>(const StructType &st) {
+			return st.to_string();
+		}
 		template <> string to_string<ErrorType>(const ErrorType &et) {
 			return et.to_string();
 		}
@@ -65,6 +503,30 @@ namespace ICM
 		template <> string to_output<DisperseType>(const DisperseType &lt) {
 			return lt.to_output();
 		}
+		template <> string to_output<ArrayType>(const ArrayType &at) {
+			return at.to_output();
+		}
+		template <> string to_output<SliceType>(const SliceType &st) {
+			return st.to_output();
+		}
+		template <> string to_output<DequeType>(const DequeType &dt) {
+			return dt.to_output();
+		}
+		template <> string to_output<PQueueType>(const PQueueType &pq) {
+			return pq.to_output();
+		}
+		template <> string to_output<PVectorType>(const PVectorType &pv) {
+			return pv.to_output();
+		}
+		template <> string to_output<MapType>(const MapType &mt) {
+			return mt.to_output();
+		}
+		template <> string to_output<OrdMapType>(const OrdMapType &mt) {
+			return mt.to_output();
+		}
+		template <> string to_output<StructType>(const StructType &st) {
+			return st.to_output();
+		}
 		template <> string to_output<FunctionType>(const FunctionType &ft) {
 			return ft.to_output();
 		}
@@ -0,0 +1,543 @@
+#include "basic.h"
+#include "runtime/vecmath.h"
+#include "runtime/number.h"
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#	define ICM_VECMATH_AVX2
+#	include <immintrin.h>
+#	define AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace ICM
+{
+	namespace VecMath
+	{
+		bool hasAVX2() {
+#ifdef ICM_VECMATH_AVX2
+			static const bool result = __builtin_cpu_supports("avx2");
+			return result;
+#else
+			return false;
+#endif
+		}
+
+		namespace
+		{
+			//=======================================
+			// * Scalar Operators
+			//=======================================
+			// Return true on success.
+			template <Operator> struct IntOp;
+			template <> struct IntOp<Add> {
+				static bool s(int64_t a, int64_t b, int64_t &r) { return !Checked::add(a, b, r); }
+			};
+			template <> struct IntOp<Sub> {
+				static bool s(int64_t a, int64_t b, int64_t &r) { return !Checked::sub(a, b, r); }
+			};
+			template <> struct IntOp<Mul> {
+				static bool s(int64_t a, int64_t b, int64_t &r) { return !Checked::mul(a, b, r); }
+			};
+			template <> struct IntOp<Div> {
+				static bool s(int64_t a, int64_t b, int64_t &r) {
+					if (b == 0 || (b == -1 && a == INT64_MIN)) {
+						r = 0;
+						return false;
+					}
+					r = a / b;
+					return true;
+				}
+			};
+			template <> struct IntOp<Min> {
+				static bool s(int64_t a, int64_t b, int64_t &r) { r = a < b ? a : b; return true; }
+			};
+			template <> struct IntOp<Max> {
+				static bool s(int64_t a, int64_t b, int64_t &r) { r = a > b ? a : b; return true; }
+			};
+
+			// Min/Max follow minpd/maxpd, which return the second operand on NaN.
+			template <Operator> struct FloatOp;
+			template <> struct FloatOp<Add> { static double s(double a, double b) { return a + b; } };
+			template <> struct FloatOp<Sub> { static double s(double a, double b) { return a - b; } };
+			template <> struct FloatOp<Mul> { static double s(double a, double b) { return a * b; } };
+			template <> struct FloatOp<Div> { static double s(double a, double b) { return a / b; } };
+			template <> struct FloatOp<Min> { static double s(double a, double b) { return a < b ? a : b; } };
+			template <> struct FloatOp<Max> { static double s(double a, double b) { return a > b ? a : b; } };
+
+			template <Compare> struct CmpOp;
+			template <> struct CmpOp<Less> { template <typename T> static bool s(T a, T b) { return a < b; } };
+			template <> struct CmpOp<LessEqual> { template <typename T> static bool s(T a, T b) { return a <= b; } };
+			template <> struct CmpOp<Greater> { template <typename T> static bool s(T a, T b) { return a > b; } };
+			template <> struct CmpOp<GreaterEqual> { template <typename T> static bool s(T a, T b) { return a >= b; } };
+			template <> struct CmpOp<Equal> { template <typename T> static bool s(T a, T b) { return a == b; } };
+			template <> struct CmpOp<NotEqual> { template <typename T> static bool s(T a, T b) { return a != b; } };
+
+			template <Operator O>
+			bool calc_int_scalar(const int64_t *a, size_t sa, const int64_t *b, size_t sb, int64_t *r, size_t n) {
+				bool ok = true;
+				for (size_t i = 0; i < n; ++i)
+					ok &= IntOp<O>::s(a[i * sa], b[i * sb], r[i]);
+				return ok;
+			}
+			template <Operator O>
+			void calc_float_scalar(const double *a, size_t sa, const double *b, size_t sb, double *r, size_t n) {
+				for (size_t i = 0; i < n; ++i)
+					r[i] = FloatOp<O>::s(a[i * sa], b[i * sb]);
+			}
+			template <Compare C, typename T>
+			void compare_scalar(const T *a, size_t sa, const T *b, size_t sb, uint8_t *r, size_t n) {
+				for (size_t i = 0; i < n; ++i)
+					r[i] = CmpOp<C>::s(a[i * sa], b[i * sb]);
+			}
+
+#ifdef ICM_VECMATH_AVX2
+			//=======================================
+			// * AVX2 Operators
+			//=======================================
+			AVX2 inline __m256d load(const double *p, size_t s, size_t i) {
+				return s ? _mm256_loadu_pd(p + i) : _mm256_set1_pd(*p);
+			}
+			AVX2 inline __m256i load(const int64_t *p, size_t s, size_t i) {
+				return s ? _mm256_loadu_si256((const __m256i*)(p + i)) : _mm256_set1_epi64x(*p);
+			}
+
+			template <Operator> struct FloatVec;
+			template <> struct FloatVec<Add> { AVX2 static __m256d v(__m256d a, __m256d b) { return _mm256_add_pd(a, b); } };
+			template <> struct FloatVec<Sub> { AVX2 static __m256d v(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); } };
+			template <> struct FloatVec<Mul> { AVX2 static __m256d v(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); } };
+			template <> struct FloatVec<Div> { AVX2 static __m256d v(__m256d a, __m256d b) { return _mm256_div_pd(a, b); } };
+			template <> struct FloatVec<Min> { AVX2 static __m256d v(__m256d a, __m256d b) { return _mm256_min_pd(a, b); } };
+			template <> struct FloatVec<Max> { AVX2 static __m256d v(__m256d a, __m256d b) { return _mm256_max_pd(a, b); } };
+
+			// The sign bits of ov collect overflows.
+			template <Operator> struct IntVec;
+			template <> struct IntVec<Add> {
+				AVX2 static __m256i v(__m256i a, __m256i b, __m256i &ov) {
+					__m256i r = _mm256_add_epi64(a, b);
+					ov = _mm256_or_si256(ov, _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r)));
+					return r;
+				}
+			};
+			template <> struct IntVec<Sub> {
+				AVX2 static __m256i v(__m256i a, __m256i b, __m256i &ov) {
+					__m256i r = _mm256_sub_epi64(a, b);
+					ov = _mm256_or_si256(ov, _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r)));
+					return r;
+				}
+			};
+			template <> struct IntVec<Min> {
+				AVX2 static __m256i v(__m256i a, __m256i b, __m256i&) {
+					return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+				}
+			};
+			template <> struct IntVec<Max> {
+				AVX2 static __m256i v(__m256i a, __m256i b, __m256i&) {
+					return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+				}
+			};
+
+			// Return a 4-bit mask.
+			AVX2 inline int movemask(__m256i m) {
+				return _mm256_movemask_pd(_mm256_castsi256_pd(m));
+			}
+			template <Compare> struct CmpVec;
+			template <> struct CmpVec<Less> {
+				AVX2 static int v(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+				AVX2 static int v(__m256i a, __m256i b) { return movemask(_mm256_cmpgt_epi64(b, a)); }
+			};
+			template <> struct CmpVec<LessEqual> {
+				AVX2 static int v(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)); }
+				AVX2 static int v(__m256i a, __m256i b) { return ~movemask(_mm256_cmpgt_epi64(a, b)) & 0xf; }
+			};
+			template <> struct CmpVec<Greater> {
+				AVX2 static int v(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+				AVX2 static int v(__m256i a, __m256i b) { return movemask(_mm256_cmpgt_epi64(a, b)); }
+			};
+			template <> struct CmpVec<GreaterEqual> {
+				AVX2 static int v(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)); }
+				AVX2 static int v(__m256i a, __m256i b) { return ~movemask(_mm256_cmpgt_epi64(b, a)) & 0xf; }
+			};
+			template <> struct CmpVec<Equal> {
+				AVX2 static int v(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+				AVX2 static int v(__m256i a, __m256i b) { return movemask(_mm256_cmpeq_epi64(a, b)); }
+			};
+			template <> struct CmpVec<NotEqual> {
+				AVX2 static int v(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)); }
+				AVX2 static int v(__m256i a, __m256i b) { return ~movemask(_mm256_cmpeq_epi64(a, b)) & 0xf; }
+			};
+
+			template <Operator O>
+			AVX2 void calc_float_avx2(const double *a, size_t sa, const double *b, size_t sb, double *r, size_t n) {
+				size_t i = 0;
+				for (; i + 4 <= n; i += 4)
+					_mm256_storeu_pd(r + i, FloatVec<O>::v(load(a, sa, i), load(b, sb, i)));
+				calc_float_scalar<O>(a + i * sa, sa, b + i * sb, sb, r + i, n - i);
+			}
+			template <Operator O>
+			AVX2 bool calc_int_avx2(const int64_t *a, size_t sa, const int64_t *b, size_t sb, int64_t *r, size_t n) {
+				__m256i ov = _mm256_setzero_si256();
+				size_t i = 0;
+				for (; i + 4 <= n; i += 4)
+					_mm256_storeu_si256((__m256i*)(r + i), IntVec<O>::v(load(a, sa, i), load(b, sb, i), ov));
+				bool ok = movemask(ov) == 0;
+				return calc_int_scalar<O>(a + i * sa, sa, b + i * sb, sb, r + i, n - i) && ok;
+			}
+			template <Compare C, typename T>
+			AVX2 void compare_avx2(const T *a, size_t sa, const T *b, size_t sb, uint8_t *r, size_t n) {
+				size_t i = 0;
+				for (; i + 4 <= n; i += 4) {
+					int m = CmpVec<C>::v(load(a, sa, i), load(b, sb, i));
+					r[i] = m & 1;
+					r[i + 1] = (m >> 1) & 1;
+					r[i + 2] = (m >> 2) & 1;
+					r[i + 3] = (m >> 3) & 1;
+				}
+				compare_scalar<C>(a + i * sa, sa, b + i * sb, sb, r + i, n - i);
+			}
+#endif
+
+			template <typename T>
+			void compare_dispatch(Compare op, const T *a, size_t sa, const T *b, size_t sb, uint8_t *r, size_t n) {
+#ifdef ICM_VECMATH_AVX2
+				if (hasAVX2()) {
+					switch (op) {
+					case Less:         return compare_avx2<Less>(a, sa, b, sb, r, n);
+					case LessEqual:    return compare_avx2<LessEqual>(a, sa, b, sb, r, n);
+					case Greater:      return compare_avx2<Greater>(a, sa, b, sb, r, n);
+					case GreaterEqual: return compare_avx2<GreaterEqual>(a, sa, b, sb, r, n);
+					case Equal:        return compare_avx2<Equal>(a, sa, b, sb, r, n);
+					case NotEqual:     return compare_avx2<NotEqual>(a, sa, b, sb, r, n);
+					}
+				}
+#endif
+				switch (op) {
+				case Less:         return compare_scalar<Less>(a, sa, b, sb, r, n);
+				case LessEqual:    return compare_scalar<LessEqual>(a, sa, b, sb, r, n);
+				case Greater:      return compare_scalar<Greater>(a, sa, b, sb, r, n);
+				case GreaterEqual: return compare_scalar<GreaterEqual>(a, sa, b, sb, r, n);
+				case Equal:        return compare_scalar<Equal>(a, sa, b, sb, r, n);
+				case NotEqual:     return compare_scalar<NotEqual>(a, sa, b, sb, r, n);
+				}
+			}
+		}
+
+		//=======================================
+		// * Dispatch
+		//=======================================
+		bool calc(Operator op, const int64_t *a, size_t sa, const int64_t *b, size_t sb, int64_t *r, size_t n) {
+#ifdef ICM_VECMATH_AVX2
+			// AVX2 has no 64-bit multiply or divide, those stay scalar.
+			if (hasAVX2()) {
+				switch (op) {
+				case Add: return calc_int_avx2<Add>(a, sa, b, sb, r, n);
+				case Sub: return calc_int_avx2<Sub>(a, sa, b, sb, r, n);
+				case Min: return calc_int_avx2<Min>(a, sa, b, sb, r, n);
+				case Max: return calc_int_avx2<Max>(a, sa, b, sb, r, n);
+				default:  break;
+				}
+			}
+#endif
+			switch (op) {
+			case Add: return calc_int_scalar<Add>(a, sa, b, sb, r, n);
+			case Sub: return calc_int_scalar<Sub>(a, sa, b, sb, r, n);
+			case Mul: return calc_int_scalar<Mul>(a, sa, b, sb, r, n);
+			case Div: return calc_int_scalar<Div>(a, sa, b, sb, r, n);
+			case Min: return calc_int_scalar<Min>(a, sa, b, sb, r, n);
+			case Max: return calc_int_scalar<Max>(a, sa, b, sb, r, n);
+			}
+			return false;
+		}
+		bool calc(Operator op, const double *a, size_t sa, const double *b, size_t sb, double *r, size_t n) {
+#ifdef ICM_VECMATH_AVX2
+			if (hasAVX2()) {
+				switch (op) {
+				case Add: calc_float_avx2<Add>(a, sa, b, sb, r, n); return true;
+				case Sub: calc_float_avx2<Sub>(a, sa, b, sb, r, n); return true;
+				case Mul: calc_float_avx2<Mul>(a, sa, b, sb, r, n); return true;
+				case Div: calc_float_avx2<Div>(a, sa, b, sb, r, n); return true;
+				case Min: calc_float_avx2<Min>(a, sa, b, sb, r, n); return true;
+				case Max: calc_float_avx2<Max>(a, sa, b, sb, r, n); return true;
+				}
+			}
+#endif
+			switch (op) {
+			case Add: calc_float_scalar<Add>(a, sa, b, sb, r, n); break;
+			case Sub: calc_float_scalar<Sub>(a, sa, b, sb, r, n); break;
+			case Mul: calc_float_scalar<Mul>(a, sa, b, sb, r, n); break;
+			case Div: calc_float_scalar<Div>(a, sa, b, sb, r, n); break;
+			case Min: calc_float_scalar<Min>(a, sa, b, sb, r, n); break;
+			case Max: calc_float_scalar<Max>(a, sa, b, sb, r, n); break;
+			}
+			return true;
+		}
+		void compare(Compare op, const int64_t *a, size_t sa, const int64_t *b, size_t sb, uint8_t *r, size_t n) {
+			compare_dispatch(op, a, sa, b, sb, r, n);
+		}
+		void compare(Compare op, const double *a, size_t sa, const double *b, size_t sb, uint8_t *r, size_t n) {
+			compare_dispatch(op, a, sa, b, sb, r, n);
+		}
+
+		namespace
+		{
+			//=======================================
+			// * Int128
+			//---------------------------------------
+			//   Two-word accumulator for exact integer sums.
+			//=======================================
+			struct Int128
+			{
+				uint64_t lo = 0;
+				int64_t hi = 0;
+
+				void add(int64_t x) {
+					uint64_t r = lo + (uint64_t)x;
+					hi += (r < lo) - (x < 0);
+					lo = r;
+				}
+				bool get(int64_t &r) const {
+					r = (int64_t)lo;
+					return hi == (r < 0 ? -1 : 0);
+				}
+				double to_double() const {
+					return (double)hi * 18446744073709551616.0 + (double)lo;
+				}
+			};
+
+			Int128 sum_exact_int(const int64_t *a, size_t n) {
+				Int128 acc;
+				for (size_t i = 0; i < n; ++i)
+					acc.add(a[i]);
+				return acc;
+			}
+
+			// Four independent chains, so that the additions can overlap.
+			template <Operator O>
+			double reduce_float_scalar(const double *a, size_t n, double init) {
+				double r0 = init, r1 = init, r2 = init, r3 = init;
+				size_t i = 0;
+				for (; i + 4 <= n; i += 4) {
+					r0 = FloatOp<O>::s(r0, a[i]);
+					r1 = FloatOp<O>::s(r1, a[i + 1]);
+					r2 = FloatOp<O>::s(r2, a[i + 2]);
+					r3 = FloatOp<O>::s(r3, a[i + 3]);
+				}
+				for (; i < n; ++i)
+					r0 = FloatOp<O>::s(r0, a[i]);
+				return FloatOp<O>::s(FloatOp<O>::s(r0, r1), FloatOp<O>::s(r2, r3));
+			}
+			template <Operator O>
+			int64_t reduce_int_scalar(const int64_t *a, size_t n, int64_t init) {
+				int64_t r = init;
+				for (size_t i = 0; i < n; ++i)
+					IntOp<O>::s(r, a[i], r);
+				return r;
+			}
+
+#ifdef ICM_VECMATH_AVX2
+			AVX2 inline double hreduce(__m256d v, double (*f)(double, double)) {
+				alignas(32) double t[4];
+				_mm256_store_pd(t, v);
+				return f(f(t[0], t[1]), f(t[2], t[3]));
+			}
+
+			// Four vector accumulators, sixteen lanes in total.
+			template <Operator O>
+			AVX2 double reduce_float_avx2(const double *a, size_t n, double init) {
+				__m256d r0 = _mm256_set1_pd(init), r1 = r0, r2 = r0, r3 = r0;
+				size_t i = 0;
+				for (; i + 16 <= n; i += 16) {
+					r0 = FloatVec<O>::v(r0, _mm256_loadu_pd(a + i));
+					r1 = FloatVec<O>::v(r1, _mm256_loadu_pd(a + i + 4));
+					r2 = FloatVec<O>::v(r2, _mm256_loadu_pd(a + i + 8));
+					r3 = FloatVec<O>::v(r3, _mm256_loadu_pd(a + i + 12));
+				}
+				for (; i + 4 <= n; i += 4)
+					r0 = FloatVec<O>::v(r0, _mm256_loadu_pd(a + i));
+				double r = hreduce(FloatVec<O>::v(FloatVec<O>::v(r0, r1), FloatVec<O>::v(r2, r3)), FloatOp<O>::s);
+				return FloatOp<O>::s(r, reduce_float_scalar<O>(a + i, n - i, init));
+			}
+
+			AVX2 double dot_float_avx2(const double *a, const double *b, size_t n) {
+				__m256d r0 = _mm256_setzero_pd(), r1 = r0, r2 = r0, r3 = r0;
+				size_t i = 0;
+				for (; i + 16 <= n; i += 16) {
+					r0 = _mm256_add_pd(r0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+					r1 = _mm256_add_pd(r1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+					r2 = _mm256_add_pd(r2, _mm256_mul_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8)));
+					r3 = _mm256_add_pd(r3, _mm256_mul_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12)));
+				}
+				double r = hreduce(_mm256_add_pd(_mm256_add_pd(r0, r1), _mm256_add_pd(r2, r3)), FloatOp<Add>::s);
+				for (; i < n; ++i)
+					r += a[i] * b[i];
+				return r;
+			}
+
+			// Return false if any lane overflowed.
+			AVX2 bool sum_int_avx2(const int64_t *a, size_t n, int64_t &r) {
+				__m256i r0 = _mm256_setzero_si256(), r1 = r0, ov = r0;
+				size_t i = 0;
+				for (; i + 8 <= n; i += 8) {
+					r0 = IntVec<Add>::v(r0, _mm256_loadu_si256((const __m256i*)(a + i)), ov);
+					r1 = IntVec<Add>::v(r1, _mm256_loadu_si256((const __m256i*)(a + i + 4)), ov);
+				}
+				if (movemask(ov) != 0)
+					return false;
+				alignas(32) int64_t t[8];
+				_mm256_store_si256((__m256i*)t, r0);
+				_mm256_store_si256((__m256i*)(t + 4), r1);
+				bool ok = true;
+				r = 0;
+				for (int64_t v : t)
+					ok &= IntOp<Add>::s(r, v, r);
+				for (; i < n; ++i)
+					ok &= IntOp<Add>::s(r, a[i], r);
+				return ok;
+			}
+
+			template <Operator O>
+			AVX2 int64_t reduce_int_avx2(const int64_t *a, size_t n, int64_t init) {
+				__m256i r0 = _mm256_set1_epi64x(init), r1 = r0, ov = _mm256_setzero_si256();
+				size_t i = 0;
+				for (; i + 8 <= n; i += 8) {
+					r0 = IntVec<O>::v(r0, _mm256_loadu_si256((const __m256i*)(a + i)), ov);
+					r1 = IntVec<O>::v(r1, _mm256_loadu_si256((const __m256i*)(a + i + 4)), ov);
+				}
+				alignas(32) int64_t t[4];
+				_mm256_store_si256((__m256i*)t, IntVec<O>::v(r0, r1, ov));
+				return reduce_int_scalar<O>(a + i, n - i, reduce_int_scalar<O>(t, 4, init));
+			}
+#endif
+
+			template <Operator O>
+			double reduce_float(const double *a, size_t n, double init) {
+#ifdef ICM_VECMATH_AVX2
+				if (hasAVX2())
+					return reduce_float_avx2<O>(a, n, init);
+#endif
+				return reduce_float_scalar<O>(a, n, init);
+			}
+			template <Operator O>
+			int64_t reduce_int(const int64_t *a, size_t n) {
+#ifdef ICM_VECMATH_AVX2
+				if (hasAVX2())
+					return reduce_int_avx2<O>(a, n, a[0]);
+#endif
+				return reduce_int_scalar<O>(a, n, a[0]);
+			}
+		}
+
+		//=======================================
+		// * Reductions
+		//=======================================
+		bool sum(const int64_t *a, size_t n, int64_t &r) {
+#ifdef ICM_VECMATH_AVX2
+			if (hasAVX2() && sum_int_avx2(a, n, r))
+				return true;
+#endif
+			// Fall back to the exact sum, it only fails if the total is out of range.
+			return sum_exact_int(a, n).get(r);
+		}
+		double sum(const double *a, size_t n) {
+			return reduce_float<Add>(a, n, 0.0);
+		}
+		double sum_exact(const double *a, size_t n) {
+			// Keep the sum as a list of non-overlapping partials.
+			vector<double> partials;
+			for (size_t k = 0; k < n; ++k) {
+				double x = a[k];
+				size_t i = 0;
+				for (double y : partials) {
+					if (std::abs(x) < std::abs(y))
+						std::swap(x, y);
+					double hi = x + y;
+					double lo = y - (hi - x);
+					if (lo != 0.0)
+						partials[i++] = lo;
+					x = hi;
+				}
+				partials.resize(i);
+				partials.push_back(x);
+			}
+			// Add the partials from the top, with the correction for half-way cases.
+			if (partials.empty())
+				return 0.0;
+			size_t i = partials.size() - 1;
+			double hi = partials[i];
+			double lo = 0.0;
+			while (i > 0) {
+				double x = hi;
+				double y = partials[--i];
+				hi = x + y;
+				lo = y - (hi - x);
+				if (lo != 0.0)
+					break;
+			}
+			if (i > 0 && ((lo < 0 && partials[i - 1] < 0) || (lo > 0 && partials[i - 1] > 0))) {
+				double y = lo * 2;
+				double x = hi + y;
+				if (y == x - hi)
+					hi = x;
+			}
+			return hi;
+		}
+		bool product(const int64_t *a, size_t n, int64_t &r) {
+			r = 1;
+			for (size_t i = 0; i < n; ++i) {
+				if (!IntOp<Mul>::s(r, a[i], r)) {
+					// The product is still exact if a zero follows.
+					r = 0;
+					return std::find(a + i, a + n, 0) != a + n;
+				}
+			}
+			return true;
+		}
+		double product(const double *a, size_t n) {
+			return reduce_float<Mul>(a, n, 1.0);
+		}
+		int64_t min(const int64_t *a, size_t n) {
+			return reduce_int<Min>(a, n);
+		}
+		double min(const double *a, size_t n) {
+			return reduce_float<Min>(a, n, a[0]);
+		}
+		int64_t max(const int64_t *a, size_t n) {
+			return reduce_int<Max>(a, n);
+		}
+		double max(const double *a, size_t n) {
+			return reduce_float<Max>(a, n, a[0]);
+		}
+		double mean(const int64_t *a, size_t n) {
+			return sum_exact_int(a, n).to_double() / n;
+		}
+		double mean(const double *a, size_t n) {
+			return sum(a, n) / n;
+		}
+		bool dot(const int64_t *a, const int64_t *b, size_t n, int64_t &r) {
+			Int128 acc;
+			for (size_t i = 0; i < n; ++i) {
+				int64_t p;
+				if (!IntOp<Mul>::s(a[i], b[i], p))
+					return false;
+				acc.add(p);
+			}
+			return acc.get(r);
+		}
+		double dot(const double *a, const double *b, size_t n) {
+#ifdef ICM_VECMATH_AVX2
+			if (hasAVX2())
+				return dot_float_avx2(a, b, n);
+#endif
+			double r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				r0 += a[i] * b[i];
+				r1 += a[i + 1] * b[i + 1];
+				r2 += a[i + 2] * b[i + 2];
+				r3 += a[i + 3] * b[i + 3];
+			}
+			for (; i < n; ++i)
+				r0 += a[i] * b[i];
+			return (r0 + r1) + (r2 + r3);
+		}
+	}
+}
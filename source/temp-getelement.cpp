@@ -26,6 +26,9 @@ namespace ICM
 		if (elt.getLiteralType() == T_String) {
 			dat = new Compiler::Literal::StringType(const_cast<char*>(static_cast<const char*>(dat))); // TODO
 		}
+		else if (elt.getLiteralType() == T_Number) {
+			dat = &EP.getNumber(elt.getIndex());
+		}
 		else if (elt.getLiteralType() == T_Nil) {
 			dat = nullptr;
 		}
@@ -22,8 +22,16 @@ namespace ICM
 			case T_Boolean:    return "Boolean";
 			case T_String:     return "String";
 			case T_Symbol:     return "Symbol";
+			case T_Array:      return "Array";
 			case T_List:       return "List";
 			case T_Disperse:   return "Disperse";
+			case T_PVector:    return "PVector";
+			case T_Slice:      return "Slice";
+			case T_Deque:      return "Deque";
+			case T_PQueue:     return "PQueue";
+			case T_Map:        return "Map";
+			case T_OrdMap:     return "OrdMap";
+			case T_Struct:     return "Struct";
 			case T_Vary:       return "Vary";
 			case T_Function:   return "Function";
 			case T_Type:       return "Type";